@@ -10,6 +10,13 @@
 #include <limits>
 #include <fstream>
 #include <sstream>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <thread>
 
 // Forward Declarations
 class Piece;
@@ -572,6 +579,416 @@ void Board::setupInitialPieces() {
 }
 
 
+// Win/draw bitbases for KPK, KQK, KRK and KBNK, built offline by retrograde analysis.
+// Tables are stored from the strong side's point of view as "white": one bit per position
+// for white to move (set = white wins) and one for black to move (set = black loses).
+// Squares are numbered a1 = 0 ... h8 = 63; a position index packs the squares of the
+// white king, black king and the extra white pieces, 6 bits each.
+class EndgameBitbases {
+public:
+    enum Kind { KPK, KQK, KRK, KBNK, KIND_COUNT };
+    static const int WIN_SCORE = 10000;
+
+    static EndgameBitbases& instance() {
+        static EndgameBitbases bitbases;
+        return bitbases;
+    }
+
+    // Generates every table (KQK and KRK first, KPK needs them for promotions) and writes them to disk.
+    void generateAll(unsigned threadCount, const std::string& directory = ".") {
+        const Kind order[] = { KQK, KRK, KPK, KBNK };
+        for (Kind kind : order) {
+            auto t1 = std::chrono::steady_clock::now();
+            size_t wins = generate(kind, threadCount);
+            std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - t1;
+            std::string path = directory + "/" + fileName(kind);
+            bool saved = save(kind, path);
+            std::cout << kindName(kind) << ": " << wins << " won positions in " << std::fixed << std::setprecision(2)
+                << seconds.count() << " s" << (saved ? " -> " + path : " (could not write " + path + ")") << std::endl;
+        }
+    }
+
+    int loadAll(const std::string& directory = ".") {
+        int loadedCount = 0;
+        for (int k = 0; k < KIND_COUNT; ++k) {
+            if (load(static_cast<Kind>(k), directory + "/" + fileName(static_cast<Kind>(k)))) loadedCount++;
+        }
+        return loadedCount;
+    }
+
+    // Looks up positions with a lone king against K+P, K+Q, K+R or K+B+N.
+    // On success 'score' is from 'perspective': 0 for a draw, +/-(WIN_SCORE + mop-up bonus) for a win.
+    bool probe(const Board& board, PieceColor sideToMove, PieceColor perspective, int& score) const {
+        int whiteKing = -1, blackKing = -1, pieceCount = 0;
+        PieceColor strongSide = PieceColor::NONE;
+        std::vector<std::pair<PieceType, int>> extras;
+        for (int r = 0; r < 8; ++r) {
+            for (int c = 0; c < 8; ++c) {
+                std::shared_ptr<Piece> p = board.grid[r][c];
+                if (!p) continue;
+                if (++pieceCount > 4) return false;
+                int sq = (7 - r) * 8 + c;
+                if (p->getType() == PieceType::KING) {
+                    (p->getColor() == PieceColor::WHITE ? whiteKing : blackKing) = sq;
+                    continue;
+                }
+                if (strongSide != PieceColor::NONE && strongSide != p->getColor()) return false;
+                strongSide = p->getColor();
+                extras.push_back({ p->getType(), sq });
+            }
+        }
+        if (strongSide == PieceColor::NONE || whiteKing < 0 || blackKing < 0) return false;
+
+        Kind kind;
+        std::sort(extras.begin(), extras.end(), [](const std::pair<PieceType, int>& a, const std::pair<PieceType, int>& b) {
+            return a.first == PieceType::BISHOP && b.first != PieceType::BISHOP;
+        });
+        if (extras.size() == 1 && extras[0].first == PieceType::PAWN) kind = KPK;
+        else if (extras.size() == 1 && extras[0].first == PieceType::QUEEN) kind = KQK;
+        else if (extras.size() == 1 && extras[0].first == PieceType::ROOK) kind = KRK;
+        else if (extras.size() == 2 && extras[0].first == PieceType::BISHOP && extras[1].first == PieceType::KNIGHT) kind = KBNK;
+        else return false;
+        const Table& table = tables[kind];
+        if (!table.loaded) return false;
+
+        // Mirror the ranks so that the strong side always plays "white" in the table.
+        int strongKing = whiteKing, weakKing = blackKing;
+        if (strongSide == PieceColor::BLACK) {
+            strongKing = blackKing ^ 56;
+            weakKing = whiteKing ^ 56;
+            for (auto& e : extras) e.second ^= 56;
+        }
+        size_t index = static_cast<size_t>(strongKing) << 6 | weakKing;
+        for (const auto& e : extras) index = index << 6 | e.second;
+
+        bool strongWins = (sideToMove == strongSide) ? testBit(table.whiteToMoveWins, index) : testBit(table.blackToMoveLosses, index);
+        if (!strongWins) {
+            score = 0;
+            return true;
+        }
+        int magnitude = WIN_SCORE + mopUpBonus(kind, strongKing, weakKing, extras);
+        score = (perspective == strongSide) ? magnitude : -magnitude;
+        return true;
+    }
+
+private:
+    struct Table {
+        std::vector<uint64_t> whiteToMoveWins;
+        std::vector<uint64_t> blackToMoveLosses;
+        bool loaded = false;
+    };
+    // A decoded table position: kings and up to two extra white pieces.
+    struct Setup {
+        int whiteKing, blackKing;
+        int extraCount;
+        PieceType extraType[2];
+        int extraSquare[2];
+    };
+    std::array<Table, KIND_COUNT> tables;
+
+    static const char* kindName(Kind kind) {
+        static const char* names[] = { "KPK", "KQK", "KRK", "KBNK" };
+        return names[kind];
+    }
+    static std::string fileName(Kind kind) {
+        std::string name = kindName(kind);
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        return name + ".bb";
+    }
+    static int extraCountOf(Kind kind) { return kind == KBNK ? 2 : 1; }
+    static size_t tableSize(Kind kind) { return size_t(1) << (6 * (2 + extraCountOf(kind))); }
+    static bool testBit(const std::vector<uint64_t>& bits, size_t index) { return (bits[index >> 6] >> (index & 63)) & 1; }
+
+    static int fileOf(int sq) { return sq & 7; }
+    static int rankOf(int sq) { return sq >> 3; }
+    static int distance(int a, int b) { return std::max(std::abs(fileOf(a) - fileOf(b)), std::abs(rankOf(a) - rankOf(b))); }
+    static bool onBoard(int file, int rank) { return file >= 0 && file < 8 && rank >= 0 && rank < 8; }
+
+    static Setup decode(Kind kind, size_t index) {
+        Setup s;
+        s.extraCount = extraCountOf(kind);
+        if (kind == KBNK) {
+            s.extraType[0] = PieceType::BISHOP; s.extraType[1] = PieceType::KNIGHT;
+        }
+        else {
+            s.extraType[0] = (kind == KPK) ? PieceType::PAWN : (kind == KQK) ? PieceType::QUEEN : PieceType::ROOK;
+        }
+        for (int i = s.extraCount - 1; i >= 0; --i) {
+            s.extraSquare[i] = static_cast<int>(index & 63);
+            index >>= 6;
+        }
+        s.blackKing = static_cast<int>(index & 63);
+        s.whiteKing = static_cast<int>(index >> 6);
+        return s;
+    }
+    static size_t encode(const Setup& s) {
+        size_t index = static_cast<size_t>(s.whiteKing) << 6 | s.blackKing;
+        for (int i = 0; i < s.extraCount; ++i) index = index << 6 | s.extraSquare[i];
+        return index;
+    }
+    static uint64_t occupancy(const Setup& s) {
+        uint64_t occ = (1ULL << s.whiteKing) | (1ULL << s.blackKing);
+        for (int i = 0; i < s.extraCount; ++i) occ |= 1ULL << s.extraSquare[i];
+        return occ;
+    }
+    static bool isValidSetup(const Setup& s) {
+        if (s.whiteKing == s.blackKing || distance(s.whiteKing, s.blackKing) <= 1) return false;
+        uint64_t seen = (1ULL << s.whiteKing) | (1ULL << s.blackKing);
+        for (int i = 0; i < s.extraCount; ++i) {
+            uint64_t bit = 1ULL << s.extraSquare[i];
+            if (seen & bit) return false;
+            seen |= bit;
+            if (s.extraType[i] == PieceType::PAWN && (rankOf(s.extraSquare[i]) == 0 || rankOf(s.extraSquare[i]) == 7)) return false;
+        }
+        return true;
+    }
+
+    static bool slides(int from, int to, int df, int dr, uint64_t occ) {
+        int f = fileOf(from) + df, r = rankOf(from) + dr;
+        while (onBoard(f, r)) {
+            int sq = r * 8 + f;
+            if (sq == to) return true;
+            if (occ & (1ULL << sq)) return false;
+            f += df; r += dr;
+        }
+        return false;
+    }
+    static bool pieceAttacks(PieceType type, int from, int to, uint64_t occ) {
+        int df = fileOf(to) - fileOf(from), dr = rankOf(to) - rankOf(from);
+        if (df == 0 && dr == 0) return false;
+        switch (type) {
+        case PieceType::KING: return std::abs(df) <= 1 && std::abs(dr) <= 1;
+        case PieceType::KNIGHT: return (std::abs(df) == 1 && std::abs(dr) == 2) || (std::abs(df) == 2 && std::abs(dr) == 1);
+        case PieceType::PAWN: return dr == 1 && std::abs(df) == 1;
+        case PieceType::BISHOP:
+            return std::abs(df) == std::abs(dr) && slides(from, to, df > 0 ? 1 : -1, dr > 0 ? 1 : -1, occ);
+        case PieceType::ROOK:
+            return (df == 0 || dr == 0) && slides(from, to, (df > 0) - (df < 0), (dr > 0) - (dr < 0), occ);
+        case PieceType::QUEEN:
+            return (df == 0 || dr == 0 || std::abs(df) == std::abs(dr)) && slides(from, to, (df > 0) - (df < 0), (dr > 0) - (dr < 0), occ);
+        default: return false;
+        }
+    }
+    // 'skipExtra' ignores a piece that the black king is about to capture.
+    static bool whiteAttacks(const Setup& s, int sq, uint64_t occ, int skipExtra = -1) {
+        if (distance(s.whiteKing, sq) == 1) return true;
+        for (int i = 0; i < s.extraCount; ++i) {
+            if (i != skipExtra && pieceAttacks(s.extraType[i], s.extraSquare[i], sq, occ)) return true;
+        }
+        return false;
+    }
+
+    // Number of legal black king moves; 'inCheck' tells mate from stalemate when it is zero.
+    static int countBlackMoves(const Setup& s, bool& inCheck) {
+        uint64_t occWithoutKing = occupancy(s) & ~(1ULL << s.blackKing);
+        inCheck = whiteAttacks(s, s.blackKing, occupancy(s));
+        int count = 0;
+        for (int df = -1; df <= 1; ++df) {
+            for (int dr = -1; dr <= 1; ++dr) {
+                int f = fileOf(s.blackKing) + df, r = rankOf(s.blackKing) + dr;
+                if ((df == 0 && dr == 0) || !onBoard(f, r)) continue;
+                int to = r * 8 + f;
+                if (distance(to, s.whiteKing) <= 1) continue;
+                int captured = -1;
+                for (int i = 0; i < s.extraCount; ++i) if (s.extraSquare[i] == to) captured = i;
+                uint64_t occ = (captured >= 0) ? (occWithoutKing & ~(1ULL << to)) : occWithoutKing;
+                if (!whiteAttacks(s, to, occ | (1ULL << to), captured)) count++;
+            }
+        }
+        return count;
+    }
+
+    // Squares a white piece on 'from' could have come from without capturing.
+    static std::vector<int> whiteUnmoves(PieceType type, int from, uint64_t occ) {
+        std::vector<int> origins;
+        if (type == PieceType::PAWN) {
+            int one = from - 8;
+            if (rankOf(from) >= 2 && !(occ & (1ULL << one))) {
+                origins.push_back(one);
+                if (rankOf(from) == 3 && !(occ & (1ULL << (from - 16)))) origins.push_back(from - 16);
+            }
+            return origins;
+        }
+        for (int to = 0; to < 64; ++to) {
+            if (!(occ & (1ULL << to)) && pieceAttacks(type, from, to, occ)) origins.push_back(to);
+        }
+        return origins;
+    }
+
+    // Mop-up terms that steer the search toward actually delivering mate or promoting.
+    static int mopUpBonus(Kind kind, int strongKing, int weakKing, const std::vector<std::pair<PieceType, int>>& extras) {
+        int weakFile = fileOf(weakKing), weakRank = rankOf(weakKing);
+        int centerDistance = std::max(3 - weakFile, weakFile - 4) + std::max(3 - weakRank, weakRank - 4);
+        int bonus = 10 * centerDistance - 4 * distance(strongKing, weakKing);
+        if (kind == KPK) {
+            bonus += 20 * rankOf(extras[0].second);
+        }
+        else if (kind == KBNK) {
+            // Mate is only possible in a corner of the bishop's colour.
+            bool lightBishop = (fileOf(extras[0].second) + rankOf(extras[0].second)) % 2 == 1;
+            int cornerA = lightBishop ? 7 : 0, cornerB = lightBishop ? 56 : 63;
+            bonus += 20 * (7 - std::min(distance(weakKing, cornerA), distance(weakKing, cornerB)));
+        }
+        return bonus;
+    }
+
+    static void setAtomicBit(std::vector<std::atomic<uint64_t>>& bits, size_t index, bool& wasSet) {
+        uint64_t mask = 1ULL << (index & 63);
+        wasSet = (bits[index >> 6].fetch_or(mask, std::memory_order_relaxed) & mask) != 0;
+    }
+
+    // Retrograde analysis: positions are resolved ply by ply backwards from the mates. White-to-move
+    // predecessors of a black loss are wins; a black-to-move position is lost once every one of its
+    // moves has been shown to reach a white win (tracked with a per-position counter). Each level of
+    // the frontier, and the initial scan, is split across threads.
+    size_t generate(Kind kind, unsigned threadCount) {
+        const size_t size = tableSize(kind);
+        threadCount = std::max(1u, threadCount);
+        std::vector<std::atomic<uint64_t>> wtmWins(size / 64), btmLosses(size / 64);
+        std::vector<std::atomic<uint8_t>> remainingMoves(size);
+        for (auto& w : wtmWins) w.store(0, std::memory_order_relaxed);
+        for (auto& w : btmLosses) w.store(0, std::memory_order_relaxed);
+
+        // Frontier entries carry the side to move in the lowest bit.
+        std::vector<std::vector<size_t>> localFrontiers(threadCount);
+        auto runParallel = [threadCount](size_t count, const std::function<void(unsigned, size_t, size_t)>& work) {
+            std::vector<std::thread> workers;
+            size_t chunk = (count + threadCount - 1) / threadCount;
+            for (unsigned t = 0; t < threadCount; ++t) {
+                size_t begin = std::min(count, t * chunk), end = std::min(count, begin + chunk);
+                workers.emplace_back(work, t, begin, end);
+            }
+            for (auto& w : workers) w.join();
+        };
+
+        runParallel(size, [&](unsigned t, size_t begin, size_t end) {
+            for (size_t index = begin; index < end; ++index) {
+                Setup s = decode(kind, index);
+                remainingMoves[index].store(0, std::memory_order_relaxed);
+                if (!isValidSetup(s)) continue;
+                bool inCheck;
+                int moves = countBlackMoves(s, inCheck);
+                remainingMoves[index].store(static_cast<uint8_t>(moves), std::memory_order_relaxed);
+                if (moves == 0 && inCheck) {
+                    bool wasSet;
+                    setAtomicBit(btmLosses, index, wasSet);
+                    localFrontiers[t].push_back(index << 1 | 1);
+                }
+                if (kind == KPK && !whiteAttacks(s, s.blackKing, occupancy(s)) && rankOf(s.extraSquare[0]) == 6) {
+                    // A promotion that lands in a lost KQK/KRK position for black wins outright.
+                    int promotion = s.extraSquare[0] + 8;
+                    if (occupancy(s) & (1ULL << promotion)) continue;
+                    for (Kind promoted : { KQK, KRK }) {
+                        Setup next = s;
+                        next.extraSquare[0] = promotion;
+                        if (tables[promoted].loaded && testBit(tables[promoted].blackToMoveLosses, encode(next))) {
+                            bool wasSet;
+                            setAtomicBit(wtmWins, index, wasSet);
+                            if (!wasSet) localFrontiers[t].push_back(index << 1);
+                            break;
+                        }
+                    }
+                }
+            }
+        });
+
+        std::vector<size_t> frontier;
+        while (true) {
+            frontier.clear();
+            for (auto& local : localFrontiers) {
+                frontier.insert(frontier.end(), local.begin(), local.end());
+                local.clear();
+            }
+            if (frontier.empty()) break;
+
+            runParallel(frontier.size(), [&](unsigned t, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    size_t index = frontier[i] >> 1;
+                    bool blackToMove = frontier[i] & 1;
+                    Setup s = decode(kind, index);
+                    uint64_t occ = occupancy(s);
+                    if (blackToMove) {
+                        // Black is lost here: every white move that leads here wins.
+                        for (int piece = -1; piece < s.extraCount; ++piece) {
+                            int from = (piece < 0) ? s.whiteKing : s.extraSquare[piece];
+                            PieceType type = (piece < 0) ? PieceType::KING : s.extraType[piece];
+                            for (int origin : whiteUnmoves(type, from, occ)) {
+                                Setup prev = s;
+                                (piece < 0 ? prev.whiteKing : prev.extraSquare[piece]) = origin;
+                                if (!isValidSetup(prev) || whiteAttacks(prev, prev.blackKing, occupancy(prev))) continue;
+                                size_t prevIndex = encode(prev);
+                                bool wasSet;
+                                setAtomicBit(wtmWins, prevIndex, wasSet);
+                                if (!wasSet) localFrontiers[t].push_back(prevIndex << 1);
+                            }
+                        }
+                    }
+                    else {
+                        // White wins here: black king moves that lead here lose one escape each.
+                        for (int df = -1; df <= 1; ++df) {
+                            for (int dr = -1; dr <= 1; ++dr) {
+                                int f = fileOf(s.blackKing) + df, r = rankOf(s.blackKing) + dr;
+                                if ((df == 0 && dr == 0) || !onBoard(f, r)) continue;
+                                int origin = r * 8 + f;
+                                if (occ & (1ULL << origin)) continue;
+                                Setup prev = s;
+                                prev.blackKing = origin;
+                                if (!isValidSetup(prev)) continue;
+                                size_t prevIndex = encode(prev);
+                                if (btmLosses[prevIndex >> 6].load(std::memory_order_relaxed) >> (prevIndex & 63) & 1) continue;
+                                if (remainingMoves[prevIndex].fetch_sub(1, std::memory_order_relaxed) == 1) {
+                                    bool wasSet;
+                                    setAtomicBit(btmLosses, prevIndex, wasSet);
+                                    if (!wasSet) localFrontiers[t].push_back(prevIndex << 1 | 1);
+                                }
+                            }
+                        }
+                    }
+                }
+            });
+        }
+
+        Table& table = tables[kind];
+        table.whiteToMoveWins.assign(size / 64, 0);
+        table.blackToMoveLosses.assign(size / 64, 0);
+        size_t wins = 0;
+        for (size_t w = 0; w < size / 64; ++w) {
+            table.whiteToMoveWins[w] = wtmWins[w].load();
+            table.blackToMoveLosses[w] = btmLosses[w].load();
+            wins += std::bitset<64>(table.whiteToMoveWins[w]).count() + std::bitset<64>(table.blackToMoveLosses[w]).count();
+        }
+        table.loaded = true;
+        return wins;
+    }
+
+    bool save(Kind kind, const std::string& path) const {
+        const Table& table = tables[kind];
+        std::ofstream file(path, std::ios::binary);
+        if (!file) return false;
+        const char magic[4] = { 'C', 'B', 'B', static_cast<char>('0' + kind) };
+        file.write(magic, sizeof(magic));
+        file.write(reinterpret_cast<const char*>(table.whiteToMoveWins.data()), table.whiteToMoveWins.size() * sizeof(uint64_t));
+        file.write(reinterpret_cast<const char*>(table.blackToMoveLosses.data()), table.blackToMoveLosses.size() * sizeof(uint64_t));
+        return static_cast<bool>(file);
+    }
+
+    bool load(Kind kind, const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return false;
+        char magic[4];
+        if (!file.read(magic, sizeof(magic)) || magic[0] != 'C' || magic[1] != 'B' || magic[2] != 'B' || magic[3] != '0' + kind) return false;
+        Table& table = tables[kind];
+        size_t words = tableSize(kind) / 64;
+        table.whiteToMoveWins.resize(words);
+        table.blackToMoveLosses.resize(words);
+        file.read(reinterpret_cast<char*>(table.whiteToMoveWins.data()), words * sizeof(uint64_t));
+        file.read(reinterpret_cast<char*>(table.blackToMoveLosses.data()), words * sizeof(uint64_t));
+        table.loaded = static_cast<bool>(file);
+        return table.loaded;
+    }
+};
+
+
 class Player {
 public:
     PieceColor playerColor;
@@ -589,6 +1006,7 @@ private:
     Game* game_ptr;
 
     int minimax(Board currentBoard, int depth, bool isMaximizingPlayer, PieceColor aiPlayerColor) const;
+    int evaluatePosition(const Board& currentBoard, PieceColor sideToMove, PieceColor aiPlayerColor) const;
 
 public:
     AIPlayer(PieceColor color, AIDifficulty diff);
@@ -973,13 +1391,22 @@ void AIPlayer::setGamePtr(Game* gp) {
     game_ptr = gp;
 }
 
+// Bitbase result when the position is a covered endgame, plain material otherwise
+int AIPlayer::evaluatePosition(const Board& currentBoard, PieceColor sideToMove, PieceColor aiPlayerColor) const {
+    int bitbaseScore;
+    if (EndgameBitbases::instance().probe(currentBoard, sideToMove, aiPlayerColor, bitbaseScore)) {
+        return bitbaseScore;
+    }
+    return currentBoard.evaluateMaterial(aiPlayerColor);
+}
+
 int AIPlayer::minimax(Board currentBoard, int depth, bool isMaximizingPlayer, PieceColor aiPlayerColor) const {
+    PieceColor turnColor = isMaximizingPlayer ? aiPlayerColor : (aiPlayerColor == PieceColor::WHITE ? PieceColor::BLACK : PieceColor::WHITE);
     if (depth == 0) {
-        return currentBoard.evaluateMaterial(aiPlayerColor);
+        return evaluatePosition(currentBoard, turnColor, aiPlayerColor);
     }
     if (!game_ptr) return 0; // Should not happen if setGamePtr is called
 
-    PieceColor turnColor = isMaximizingPlayer ? aiPlayerColor : (aiPlayerColor == PieceColor::WHITE ? PieceColor::BLACK : PieceColor::WHITE);
     std::vector<Move> legalMoves = game_ptr->generateLegalMoves(turnColor, currentBoard);
 
     if (legalMoves.empty()) {
@@ -1044,9 +1471,9 @@ Move AIPlayer::getMove(const Board& board, Game* gameInstance) const {
             Move tempMove = move;
             tempBoard.makeMove(tempMove);
             game_ptr->applyPromotionIfAny(tempMove, tempBoard);
-            int score = tempBoard.evaluateMaterial(playerColor);
-
             PieceColor opponentColor = (playerColor == PieceColor::WHITE) ? PieceColor::BLACK : PieceColor::WHITE;
+            int score = evaluatePosition(tempBoard, opponentColor, playerColor);
+
             if (game_ptr->isKingInCheck(opponentColor, tempBoard)) {
                 score += 50;
             }
@@ -1173,7 +1600,18 @@ void displayStylizedAZD() {
 }
 
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--generate-bitbases") {
+        unsigned threads = (argc > 2) ? static_cast<unsigned>(std::max(1, std::atoi(argv[2]))) : std::max(1u, std::thread::hardware_concurrency());
+        std::cout << "Generating endgame bitbases with " << threads << " thread(s)..." << std::endl;
+        EndgameBitbases::instance().generateAll(threads);
+        return 0;
+    }
+    int bitbaseCount = EndgameBitbases::instance().loadAll();
+    if (bitbaseCount > 0) {
+        std::cout << "Loaded " << bitbaseCount << " endgame bitbase(s)." << std::endl;
+    }
+
     Game chessGame;
     chessGame.start();
     displayStylizedAZD();
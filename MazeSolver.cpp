@@ -5,21 +5,37 @@
 #include <random>
 #include <chrono>
 #include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
 #include <iomanip>
-#include <map>
 #include <set>
 #include <cmath>
 #include <limits> // Required for std::numeric_limits
 #include <algorithm> // Required for std::reverse and std::max
 #include <fstream> // Required for file I/O
 #include <string>  // Required for filenames
-#include <list>    // Useful for Prim's algorithm
+#include <cstdint> // Required for uint8_t
+#include <cstring> // Required for std::memset
+#include <cstdlib> // Required for std::atoi and std::strtoul
+#include <array>   // Required for the bit-unpacking table
+#include <new>     // Required for std::bad_alloc
 
 // Windows-specific header and settings for UTF-8
 #ifdef _WIN32
     // Prevent definition of min and max macros
 #define NOMINMAX
 #include <windows.h>
+#include <cstdio>  // Required for _fileno
+#include <io.h>    // Required for _setmode on stdout
+#include <fcntl.h> // Required for _O_BINARY
+#else
+// POSIX headers for memory-mapping maze files
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
 // --- Color Constants (ANSI Escape Codes) ---
@@ -44,7 +60,9 @@ const std::string BG_WHITE = "\033[47m";
 
 
 // --- Cell Types ---
-enum CellType {
+// Stored one byte per cell. WALL..END describe the maze itself; the rest are marks a search leaves
+// for the visualization, kept apart from the maze in Maze::overlay.
+enum CellType : uint8_t {
     WALL = 0, PATH = 1, START = 2, END = 3,
     VISITED = 4, EXPLORED = 5, SOLUTION = 6
 };
@@ -61,44 +79,386 @@ namespace std { template <> struct hash<Position> { size_t operator()(const Posi
 
 
 // --- A* Node Struct ---
-struct AStarNode { Position pos;int gCost;int hCost;int fCost()const { return gCost + hCost; }bool operator>(const AStarNode& o)const { if (fCost() != o.fCost()) { return fCost() > o.fCost(); }return hCost > o.hCost; } };
+struct AStarNode { Position pos;int gCost;int hCost;int from;int fCost()const { return gCost + hCost; }bool operator>(const AStarNode& o)const { if (fCost() != o.fCost()) { return fCost() > o.fCost(); }return hCost > o.hCost; } };
+
+
+// --- Union-Find (for Kruskal's and Eller's algorithms) ---
+// Union by rank with path halving. Ids are 32-bit, which covers any maze that fits in memory.
+struct DisjointSets {
+    std::vector<uint32_t> parent;
+    std::vector<uint8_t> rank;
+    explicit DisjointSets(size_t n = 0) { reset(n); }
+    void reset(size_t n) {
+        parent.resize(n); rank.assign(n, 0);
+        for (size_t i = 0; i < n; ++i) parent[i] = static_cast<uint32_t>(i);
+    }
+    uint32_t find(uint32_t x) {
+        while (parent[x] != x) { parent[x] = parent[parent[x]]; x = parent[x]; }
+        return x;
+    }
+    // Joins the sets of a and b; false if they were already one set.
+    bool unite(uint32_t a, uint32_t b) {
+        a = find(a); b = find(b);
+        if (a == b) return false;
+        if (rank[a] < rank[b]) std::swap(a, b);
+        parent[b] = a;
+        if (rank[a] == rank[b]) ++rank[a];
+        return true;
+    }
+};
+
+
+// --- Eller's Algorithm, One Row at a Time ---
+// Keeps only the set membership of the current row, so memory is O(width) however tall the maze.
+// Each call to next() decides which walls of the next row of maze cells are opened: openEast[j]
+// joins cell j to cell j+1, openSouth[j] joins it to the cell below. The last row joins every
+// remaining set and opens nothing south.
+class EllerRowGenerator {
+public:
+    EllerRowGenerator(int cellsWide, std::mt19937& rng)
+        : w(cellsWide), rng(rng), labels(cellsWide, -1), lastOf(cellsWide), remap(cellsWide), hasDown(cellsWide) {}
+
+    void next(bool lastRow, std::vector<uint8_t>& openEast, std::vector<uint8_t>& openSouth) {
+        openEast.assign(w, 0); openSouth.assign(w, 0);
+        // Cells not joined from above start in sets of their own. Carried sets use ids 0..used-1,
+        // so there are never more than w ids in use.
+        int used = carried;
+        for (int j = 0; j < w; ++j) if (labels[j] < 0) labels[j] = used++;
+        sets.reset(used);
+
+        // Randomly join neighbours that are in different sets (all of them on the last row)
+        for (int j = 0; j + 1 < w; ++j) {
+            if ((lastRow || rng() % 2) && sets.unite(labels[j], labels[j + 1])) openEast[j] = 1;
+        }
+        if (lastRow) return;
+
+        // Every set must continue downward at least once: its last cell goes down if none has yet
+        for (int j = 0; j < w; ++j) { uint32_t root = sets.find(labels[j]); lastOf[root] = j; hasDown[root] = 0; }
+        for (int j = 0; j < w; ++j) {
+            uint32_t root = sets.find(labels[j]);
+            if (rng() % 2 || (lastOf[root] == j && !hasDown[root])) { openSouth[j] = 1; hasDown[root] = 1; }
+        }
+
+        // Carry the sets down under compact ids; cells left behind get fresh sets next row
+        std::fill(remap.begin(), remap.begin() + used, -1);
+        carried = 0;
+        for (int j = 0; j < w; ++j) {
+            if (!openSouth[j]) { labels[j] = -1; continue; }
+            uint32_t root = sets.find(labels[j]);
+            if (remap[root] < 0) remap[root] = carried++;
+            labels[j] = remap[root];
+        }
+    }
+
+private:
+    int w;
+    std::mt19937& rng;
+    std::vector<int> labels, lastOf, remap; // Set id of each cell in the row (-1 = fresh)
+    std::vector<uint8_t> hasDown;
+    DisjointSets sets;
+    int carried = 0; // Sets carried down from the previous row
+};
+
+
+// Maze dimensions are odd (walls on both borders) and at least 5
+int oddMazeSize(int n) {
+    if (n % 2 == 0) ++n;
+    return n < 5 ? 5 : n;
+}
+
+
+// --- Row-by-Row Maze Output ---
+// What a maze file records besides the cells
+struct MazeInfo {
+    int width = 0, height = 0;
+    Position start = { -1,-1 }, end = { -1,-1 };
+    bool hasSeed = false; // Whether 'seed' regenerates this maze
+    uint32_t seed = 0;
+};
+
+// Receives a maze one grid row at a time, one CellType byte per cell, so neither the writer nor
+// the producer has to hold the whole maze. Each call returns false once the output has failed.
+class MazeRowSink {
+public:
+    virtual ~MazeRowSink() = default;
+    virtual bool begin(const MazeInfo& info) = 0;
+    virtual bool writeRow(const uint8_t* row) = 0;
+    virtual bool finish() = 0;
+};
+
+// The legacy text format: "width height", then one line per row of space-separated cell values.
+// Start and End are cell values here, and the seed is not kept.
+class TextRowSink : public MazeRowSink {
+public:
+    explicit TextRowSink(std::ostream& out) : out(out) {}
+    bool begin(const MazeInfo& info) override {
+        // Every value is a single digit, so a row is a fixed template with the digits filled in
+        line.assign(static_cast<size_t>(info.width) * 2, ' ');
+        line.back() = '\n';
+        out << info.width << " " << info.height << "\n"; // Write dimensions
+        return !out.fail();
+    }
+    bool writeRow(const uint8_t* row) override {
+        for (size_t c = 0; c * 2 < line.size(); ++c) line[c * 2] = static_cast<char>('0' + row[c]);
+        out.write(line.data(), static_cast<std::streamsize>(line.size()));
+        return !out.fail();
+    }
+    bool finish() override { out.flush(); return !out.fail(); }
+private:
+    std::ostream& out;
+    std::string line;
+};
+
+
+// --- Binary Maze Files ---
+// A 48-byte header, then the rows top to bottom, each packed 1 bit per cell (1 = wall, least
+// significant bit first) and padded to whole bytes. Start and End are open cells whose positions
+// are in the header. With MAZE_FILE_RLE each row is PackBits run-length coded on its own, so rows
+// can still be written and read one at a time. Fields are little-endian.
+struct MazeFileHeader {
+    char magic[8];      // MAZE_FILE_MAGIC
+    uint32_t width, height;
+    int32_t startR, startC, endR, endC;
+    uint64_t seed;      // Generator seed, if MAZE_FILE_SEED is set
+    uint32_t flags;
+    uint32_t reserved;
+};
+static_assert(sizeof(MazeFileHeader) == 48, "maze file header layout");
+const char MAZE_FILE_MAGIC[8] = { 'M', 'A', 'Z', 'E', 'B', 'I', 'N', '1' };
+const uint32_t MAZE_FILE_RLE = 1;
+const uint32_t MAZE_FILE_SEED = 2;
+
+// PackBits: a control byte n < 128 is followed by n+1 literal bytes; n > 128 repeats the next
+// byte 257-n times (2..128). 128 is never written and skipped when read. Only runs of three or
+// more are worth a repeat packet, so incompressible rows grow by at most one byte in 128.
+void packBitsEncode(const uint8_t* in, size_t n, std::vector<uint8_t>& out) {
+    auto runAt = [&](size_t i) { return i + 2 < n && in[i + 1] == in[i] && in[i + 2] == in[i]; };
+    size_t i = 0;
+    while (i < n) {
+        if (runAt(i)) {
+            size_t run = 3;
+            while (i + run < n && run < 128 && in[i + run] == in[i]) ++run;
+            out.push_back(static_cast<uint8_t>(257 - run)); out.push_back(in[i]); i += run; continue;
+        }
+        // Literals up to the next run
+        size_t first = i;
+        while (i < n && i - first < 128 && !runAt(i)) ++i;
+        out.push_back(static_cast<uint8_t>(i - first - 1));
+        out.insert(out.end(), in + first, in + i);
+    }
+}
+
+// Decodes exactly n bytes from [p, end), advancing p; false on truncated or overlong data.
+bool packBitsDecode(const uint8_t*& p, const uint8_t* end, uint8_t* out, size_t n) {
+    size_t o = 0;
+    while (o < n) {
+        if (p >= end) return false;
+        uint8_t control = *p++;
+        if (control < 128) {
+            size_t count = control + 1u;
+            if (count > n - o || static_cast<size_t>(end - p) < count) return false;
+            std::memcpy(out + o, p, count); p += count; o += count;
+        }
+        else if (control > 128) {
+            size_t count = 257u - control;
+            if (count > n - o || p >= end) return false;
+            std::memset(out + o, *p++, count); o += count;
+        }
+    }
+    return true;
+}
+
+class BinaryRowSink : public MazeRowSink {
+public:
+    BinaryRowSink(std::ostream& out, bool rle) : out(out), rle(rle) {}
+    bool begin(const MazeInfo& info) override {
+        MazeFileHeader header = {};
+        std::memcpy(header.magic, MAZE_FILE_MAGIC, sizeof(header.magic));
+        header.width = info.width; header.height = info.height;
+        header.startR = info.start.r; header.startC = info.start.c;
+        header.endR = info.end.r; header.endC = info.end.c;
+        header.seed = info.seed;
+        header.flags = (rle ? MAZE_FILE_RLE : 0) | (info.hasSeed ? MAZE_FILE_SEED : 0);
+        width = info.width;
+        packed.resize((static_cast<size_t>(width) + 7) / 8);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        return !out.fail();
+    }
+    bool writeRow(const uint8_t* row) override {
+        std::fill(packed.begin(), packed.end(), 0);
+        for (int c = 0; c < width; ++c) packed[c >> 3] |= static_cast<uint8_t>((row[c] == WALL) << (c & 7));
+        if (rle) {
+            encoded.clear();
+            packBitsEncode(packed.data(), packed.size(), encoded);
+            out.write(reinterpret_cast<const char*>(encoded.data()), static_cast<std::streamsize>(encoded.size()));
+        }
+        else {
+            out.write(reinterpret_cast<const char*>(packed.data()), static_cast<std::streamsize>(packed.size()));
+        }
+        return !out.fail();
+    }
+    bool finish() override { out.flush(); return !out.fail(); }
+private:
+    std::ostream& out;
+    bool rle;
+    int width = 0;
+    std::vector<uint8_t> packed, encoded;
+};
+
+// A read-only memory map of a whole file; empty if the file cannot be opened or mapped.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filename) {
+#ifdef _WIN32
+        file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (file == INVALID_HANDLE_VALUE) return;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) return;
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping == NULL) return;
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == NULL) return;
+        bytes = static_cast<const uint8_t*>(view); length = static_cast<size_t>(fileSize.QuadPart);
+#else
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view != MAP_FAILED) {
+                madvise(view, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+                bytes = static_cast<const uint8_t*>(view); length = static_cast<size_t>(st.st_size);
+            }
+        }
+        close(fd); // The mapping stays valid
+#endif
+    }
+    ~MappedFile() {
+#ifdef _WIN32
+        if (bytes) UnmapViewOfFile(bytes);
+        if (mapping != NULL) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (bytes) munmap(const_cast<uint8_t*>(bytes), length);
+#endif
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    const uint8_t* bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+#endif
+};
+
+// Generates an Eller's-algorithm maze straight into a sink, two grid rows per row of maze cells,
+// in O(width) memory: the height is limited only by the output. The same seed always gives the
+// same maze, and the same one Maze::generate() builds with Eller's algorithm from that seed. Start is
+// the top-left cell and End the bottom-right one, as placeStartEnd() picks.
+bool streamEllerMaze(int width, int height, uint32_t seed, MazeRowSink& sink) {
+    width = oddMazeSize(width); height = oddMazeSize(height);
+    std::mt19937 rng(seed);
+    int ch = height / 2, cw = width / 2;
+    EllerRowGenerator rows(cw, rng);
+    std::vector<uint8_t> openEast, openSouth;
+    std::vector<uint8_t> cellRow(width), wallRow(width, WALL);
+    MazeInfo info;
+    info.width = width; info.height = height;
+    info.start = { 1, 1 }; info.end = { height - 2, width - 2 };
+    info.hasSeed = true; info.seed = seed;
+    if (!sink.begin(info) || !sink.writeRow(wallRow.data())) return false; // Top border
+    for (int i = 0; i < ch; ++i) {
+        rows.next(i == ch - 1, openEast, openSouth);
+        std::fill(cellRow.begin(), cellRow.end(), WALL);
+        for (int j = 0; j < cw; ++j) {
+            cellRow[2 * j + 1] = PATH;
+            if (openEast[j]) cellRow[2 * j + 2] = PATH;
+            wallRow[2 * j + 1] = openSouth[j] ? PATH : WALL; // The last row opens nothing: bottom border
+        }
+        if (i == 0) cellRow[1] = START;
+        if (i == ch - 1) cellRow[width - 2] = END;
+        if (!sink.writeRow(cellRow.data()) || !sink.writeRow(wallRow.data())) return false;
+    }
+    return sink.finish();
+}
 
 
 class Maze {
 private:
     int width = 0, height = 0;
-    std::vector<std::vector<CellType>> grid;
-    std::vector<std::vector<CellType>> originalGrid; // Stores the original generated/loaded state
+    // The maze, row-major, one byte per cell (WALL, PATH, START or END), with a border of WALL
+    // sentinels one cell wide all round: the neighbours of any maze cell are at index +/-1 and
+    // +/-stride, always inside the buffer, so the solvers' inner loops need no bounds checks.
+    // Solving never changes it, so there is nothing to restore afterwards.
+    int stride = 0;
+    std::vector<uint8_t> cells;
+    // Search marks shown while visualizing, in the same layout. Only allocated once a solve is
+    // visualized, and then cleared with one memset per solve.
+    std::vector<uint8_t> overlay;
     Position start = { -1,-1 }, end = { -1,-1 };
     std::mt19937 rng; // Random number generator
+    uint32_t seed = 0; // Seed the current maze was generated from
+    bool seedKnown = false; // False for mazes loaded without one
+    bool seedPinned = false; // setSeed() was called: the next generate() uses 'seed' as given
     int visualizationDelayMs = 10; // Visualization delay in milliseconds
 
     // --- Core Helpers ---
     void initializeGrid(bool fillWalls = true) {
         if (width <= 0 || height <= 0) return;
-        grid.assign(height, std::vector<CellType>(width, fillWalls ? WALL : PATH));
+        stride = width + 2;
+        cells.assign(static_cast<size_t>(stride) * (height + 2), WALL);
+        if (!fillWalls) for (int r = 0; r < height; ++r) std::memset(&cells[index(r, 0)], PATH, width);
+        overlay.clear();
+    }
+
+    size_t index(int r, int c) const { return static_cast<size_t>(r + 1) * stride + (c + 1); }
+    Position positionOf(size_t i) const { return { static_cast<int>(i / stride) - 1, static_cast<int>(i % stride) - 1 }; }
+    CellType cellAt(int r, int c) const { return static_cast<CellType>(cells[index(r, c)]); }
+    void setCell(int r, int c, CellType type) { cells[index(r, c)] = type; }
+
+    // Index steps to the N, E, S and W neighbours.
+    void neighbourOffsets(std::ptrdiff_t offsets[4]) const {
+        offsets[0] = -stride; offsets[1] = 1; offsets[2] = stride; offsets[3] = -1;
     }
 
     bool isValid(int r, int c, bool allowWalls = false) const {
         if (r >= 0 && r < height && c >= 0 && c < width) {
-            return allowWalls || grid[r][c] != WALL;
+            return allowWalls || cellAt(r, c) != WALL;
         }
         return false;
     }
 
+    // Marks a cell for the visualization; a no-op when nothing is shown.
+    void markVisited(size_t i) {
+        if (visualizationDelayMs <= 0) return;
+        if (overlay.empty()) overlay.assign(cells.size(), 0);
+        if (cells[i] != START && cells[i] != END) overlay[i] = VISITED;
+    }
+
     // --- Generation Algorithms ---
+    // Depth-first carving on an explicit stack, so very large mazes cannot overflow the call stack
     void generateRecursiveBacktracker(int r, int c) {
-        grid[r][c] = PATH;
-        std::vector<int> directions = { 0, 1, 2, 3 }; // N, E, S, W
-        std::shuffle(directions.begin(), directions.end(), rng);
-        int dr[] = { -1, 0, 1, 0 }; int dc[] = { 0, 1, 0, -1 };
-        for (int dir : directions) {
-            int nr = r + dr[dir] * 2; int nc = c + dc[dir] * 2; // Neighbor cell
-            int wr = r + dr[dir]; int wc = c + dc[dir];       // Wall between
-            if (isValid(nr, nc, true) && grid[nr][nc] == WALL) {
-                grid[wr][wc] = PATH; // Carve wall
-                generateRecursiveBacktracker(nr, nc); // Recurse
+        setCell(r, c, PATH);
+        std::vector<Position> stack = { { r, c } };
+        int dr[] = { -1, 0, 1, 0 }; int dc[] = { 0, 1, 0, -1 }; // N, E, S, W
+        while (!stack.empty()) {
+            Position cur = stack.back();
+            int choices[4]; int count = 0;
+            for (int dir = 0; dir < 4; ++dir) {
+                int nr = cur.r + dr[dir] * 2; int nc = cur.c + dc[dir] * 2; // Neighbor cell
+                if (isValid(nr, nc, true) && cellAt(nr, nc) == WALL) choices[count++] = dir;
             }
+            if (count == 0) { stack.pop_back(); continue; } // Dead end: backtrack
+            int dir = choices[rng() % count];
+            setCell(cur.r + dr[dir], cur.c + dc[dir], PATH); // Carve wall between
+            setCell(cur.r + dr[dir] * 2, cur.c + dc[dir] * 2, PATH);
+            stack.push_back({ cur.r + dr[dir] * 2, cur.c + dc[dir] * 2 });
         }
     }
 
@@ -108,26 +468,25 @@ private:
         // Start cell (must be odd coordinates)
         int startR = (rng() % (height / 2)) * 2 + 1;
         int startC = (rng() % (width / 2)) * 2 + 1;
-        grid[startR][startC] = PATH;
+        setCell(startR, startC, PATH);
 
-        std::list<Position> frontier; // Use list for efficient random access erase
+        std::vector<Position> frontier; // Random picks are swap-removed, O(1) each
         int dr[] = { -1, 0, 1, 0 }; int dc[] = { 0, 1, 0, -1 };
 
         // Add initial frontiers
         for (int i = 0; i < 4; ++i) {
             int nr = startR + dr[i]; int nc = startC + dc[i];
-            if (isValid(nr, nc, true) && grid[nr][nc] == WALL) {
+            if (isValid(nr, nc, true) && cellAt(nr, nc) == WALL) {
                 frontier.push_back({ nr, nc });
-                grid[nr][nc] = EXPLORED; // Temporarily mark wall as frontier
+                setCell(nr, nc, EXPLORED); // Temporarily mark wall as frontier
             }
         }
 
         while (!frontier.empty()) {
             // Randomly select a frontier wall
-            auto it = frontier.begin();
-            std::advance(it, rng() % frontier.size());
-            Position wall = *it;
-            frontier.erase(it); // Remove from frontier
+            size_t pick = rng() % frontier.size();
+            Position wall = frontier[pick];
+            frontier[pick] = frontier.back(); frontier.pop_back(); // Remove from frontier
 
             // Find the path cell neighbor and the potential new path cell
             Position pathNeighbor = { -1, -1 };
@@ -139,35 +498,107 @@ private:
                 int r2 = wall.r - dr[i]; int c2 = wall.c - dc[i]; // Opposite side
 
                 // Check if r1,c1 is path and r2,c2 is wall
-                if (isValid(r1, c1) && grid[r1][c1] == PATH && isValid(r2, c2, true) && grid[r2][c2] == WALL) {
+                if (isValid(r1, c1) && cellAt(r1, c1) == PATH && isValid(r2, c2, true) && cellAt(r2, c2) == WALL) {
                     pathNeighbor = { r1, c1 }; nextCell = { r2, c2 }; break;
                 }
                 // Check if r2,c2 is path and r1,c1 is wall
-                if (isValid(r2, c2) && grid[r2][c2] == PATH && isValid(r1, c1, true) && grid[r1][c1] == WALL) {
+                if (isValid(r2, c2) && cellAt(r2, c2) == PATH && isValid(r1, c1, true) && cellAt(r1, c1) == WALL) {
                     pathNeighbor = { r2, c2 }; nextCell = { r1, c1 }; break;
                 }
             }
 
             if (nextCell.r != -1) { // Found a valid wall to carve
-                grid[wall.r][wall.c] = PATH;     // Carve wall
-                grid[nextCell.r][nextCell.c] = PATH; // Carve next cell
+                setCell(wall.r, wall.c, PATH);     // Carve wall
+                setCell(nextCell.r, nextCell.c, PATH); // Carve next cell
 
                 // Add new frontiers from the newly carved cell
                 for (int i = 0; i < 4; ++i) {
                     int nr = nextCell.r + dr[i]; int nc = nextCell.c + dc[i];
-                    if (isValid(nr, nc, true) && grid[nr][nc] == WALL) {
+                    if (isValid(nr, nc, true) && cellAt(nr, nc) == WALL) {
                         frontier.push_back({ nr, nc });
-                        grid[nr][nc] = EXPLORED; // Mark as frontier
+                        setCell(nr, nc, EXPLORED); // Mark as frontier
                     }
                 }
             }
             else {
                 // Optional: Revert wall status if it didn't lead anywhere new
-                grid[wall.r][wall.c] = WALL;
+                setCell(wall.r, wall.c, WALL);
             }
         }
         // Clean up any remaining EXPLORED markers
-        for (int r = 0; r < height; ++r) for (int c = 0; c < width; ++c) if (grid[r][c] == EXPLORED) grid[r][c] = WALL;
+        for (uint8_t& cell : cells) if (cell == EXPLORED) cell = WALL;
+    }
+
+    // The generators below work on maze cells, the odd (row, col) positions: cell (i, j) is at
+    // (2i+1, 2j+1) and the wall to its east or south is one step over.
+
+    void generateKruskal() {
+        int ch = height / 2, cw = width / 2;
+        for (int i = 0; i < ch; ++i) for (int j = 0; j < cw; ++j) setCell(2 * i + 1, 2 * j + 1, PATH);
+        // Every inner wall as cell * 2 + (0 = east, 1 = south), taken in random order
+        std::vector<uint32_t> walls;
+        walls.reserve(static_cast<size_t>(ch) * cw * 2);
+        for (int i = 0; i < ch; ++i) {
+            for (int j = 0; j < cw; ++j) {
+                uint32_t id = static_cast<uint32_t>(i) * cw + j;
+                if (j + 1 < cw) walls.push_back(id * 2);
+                if (i + 1 < ch) walls.push_back(id * 2 + 1);
+            }
+        }
+        std::shuffle(walls.begin(), walls.end(), rng);
+        DisjointSets sets(static_cast<size_t>(ch) * cw);
+        for (uint32_t wall : walls) {
+            uint32_t id = wall / 2; bool south = wall & 1;
+            if (!sets.unite(id, south ? id + cw : id + 1)) continue; // Already connected
+            int i = id / cw, j = id % cw;
+            setCell(2 * i + 1 + south, 2 * j + 1 + !south, PATH); // Carve wall
+        }
+    }
+
+    // Loop-erased random walks: unbiased (uniform spanning tree), but slow to start on big mazes
+    // while the walks hunt for the first few carved cells.
+    void generateWilson() {
+        int ch = height / 2, cw = width / 2;
+        int dr[] = { -1, 0, 1, 0 }; int dc[] = { 0, 1, 0, -1 };
+        auto inMaze = [&](int i, int j) { return cellAt(2 * i + 1, 2 * j + 1) == PATH; };
+        // Direction each walk last left a cell by; overwriting it on revisits erases the loop
+        std::vector<uint8_t> exitDir(static_cast<size_t>(ch) * cw);
+        setCell(2 * static_cast<int>(rng() % ch) + 1, 2 * static_cast<int>(rng() % cw) + 1, PATH);
+        for (int si = 0; si < ch; ++si) {
+            for (int sj = 0; sj < cw; ++sj) {
+                if (inMaze(si, sj)) continue;
+                // Walk at random until the walk hits the maze
+                int i = si, j = sj;
+                while (!inMaze(i, j)) {
+                    int dir, ni, nj;
+                    do { dir = rng() % 4; ni = i + dr[dir]; nj = j + dc[dir]; } while (ni < 0 || ni >= ch || nj < 0 || nj >= cw);
+                    exitDir[static_cast<size_t>(i) * cw + j] = static_cast<uint8_t>(dir);
+                    i = ni; j = nj;
+                }
+                // Carve the loop-erased path from the walk's start
+                i = si; j = sj;
+                while (!inMaze(i, j)) {
+                    int dir = exitDir[static_cast<size_t>(i) * cw + j];
+                    setCell(2 * i + 1, 2 * j + 1, PATH);
+                    setCell(2 * i + 1 + dr[dir], 2 * j + 1 + dc[dir], PATH);
+                    i += dr[dir]; j += dc[dir];
+                }
+            }
+        }
+    }
+
+    void generateEller() {
+        int ch = height / 2, cw = width / 2;
+        EllerRowGenerator rows(cw, rng);
+        std::vector<uint8_t> openEast, openSouth;
+        for (int i = 0; i < ch; ++i) {
+            rows.next(i == ch - 1, openEast, openSouth);
+            for (int j = 0; j < cw; ++j) {
+                setCell(2 * i + 1, 2 * j + 1, PATH);
+                if (openEast[j]) setCell(2 * i + 1, 2 * j + 2, PATH);
+                if (openSouth[j]) setCell(2 * i + 2, 2 * j + 1, PATH);
+            }
+        }
     }
 
 
@@ -176,36 +607,55 @@ private:
         // Place Start near top-left path
         start = { 1, 1 };
         // If (1,1) is a wall, find the first available path cell
-        if (grid[start.r][start.c] == WALL) { for (int r = 1; r < height; r += 2) for (int c = 1; c < width; c += 2) if (grid[r][c] == PATH) { start = { r,c }; goto found_start; } }
-    found_start: grid[start.r][start.c] = START;
+        if (cellAt(start.r, start.c) == WALL) { for (int r = 1; r < height; r += 2) for (int c = 1; c < width; c += 2) if (cellAt(r, c) == PATH) { start = { r,c }; goto found_start; } }
+    found_start: setCell(start.r, start.c, START);
 
         // Place End near bottom-right path
         end = { height - 2, width - 2 };
         // If corner is wall, find last available path cell (different from start)
-        if (grid[end.r][end.c] == WALL) {
-            for (int r = height - 2; r > 0; r -= 2) for (int c = width - 2; c > 0; c -= 2) if (grid[r][c] == PATH && Position{ r,c } != start) { end = { r,c }; goto found_end; }
+        if (cellAt(end.r, end.c) == WALL) {
+            for (int r = height - 2; r > 0; r -= 2) for (int c = width - 2; c > 0; c -= 2) if (cellAt(r, c) == PATH && Position{ r,c } != start) { end = { r,c }; goto found_end; }
             // Fallback if no other path cell found
-            if (isValid(height - 2, width - 3) && grid[height - 2][width - 3] == PATH) end = { height - 2,width - 3 };
-            else if (isValid(height - 3, width - 2) && grid[height - 3][width - 2] == PATH) end = { height - 3,width - 2 };
+            if (isValid(height - 2, width - 3) && cellAt(height - 2, width - 3) == PATH) end = { height - 2,width - 3 };
+            else if (isValid(height - 3, width - 2) && cellAt(height - 3, width - 2) == PATH) end = { height - 3,width - 2 };
             else end = start; // Worst case: end is same as start (no path possible)
         }
     found_end:
         // Try slightly offset if end defaulted to start
         if (end == start && height > 3 && width > 3) {
-            if (isValid(start.r + 1, start.c) && grid[start.r + 1][start.c] == PATH) end = { start.r + 1,start.c };
-            else if (isValid(start.r, start.c + 1) && grid[start.r][start.c + 1] == PATH) end = { start.r,start.c + 1 };
+            if (isValid(start.r + 1, start.c) && cellAt(start.r + 1, start.c) == PATH) end = { start.r + 1,start.c };
+            else if (isValid(start.r, start.c + 1) && cellAt(start.r, start.c + 1) == PATH) end = { start.r,start.c + 1 };
         }
-        grid[end.r][end.c] = END;
+        setCell(end.r, end.c, END);
     }
 
     // --- Pathfinding Helpers ---
-    std::vector<Position> reconstructPath(const std::map<Position, Position>& parentMap, Position current) {
+    // Per-solve state over the padded cell array: one visited bit per cell and a 2-bit code per
+    // cell naming the neighbour offset that led into it, so the parent is i - offsets[code].
+    struct SearchState {
+        std::vector<uint64_t> visited;
+        std::vector<uint8_t> parents;
+        explicit SearchState(size_t cellCount) : visited((cellCount + 63) / 64, 0), parents((cellCount + 3) / 4, 0) {}
+        bool isVisited(size_t i) const { return (visited[i >> 6] >> (i & 63)) & 1; }
+        void visit(size_t i) { visited[i >> 6] |= uint64_t(1) << (i & 63); }
+        int parentCode(size_t i) const { return (parents[i >> 2] >> ((i & 3) * 2)) & 3; }
+        void setParent(size_t i, int code) {
+            int shift = static_cast<int>(i & 3) * 2;
+            parents[i >> 2] = static_cast<uint8_t>((parents[i >> 2] & ~(3 << shift)) | (code << shift));
+        }
+    };
+
+    // Walks parent codes back from 'current'; parentCode(i) is the offset index that led into cell i
+    template <typename ParentCode>
+    std::vector<Position> reconstructPath(ParentCode parentCode, const std::ptrdiff_t offsets[4], size_t current) {
         std::vector<Position> path;
-        while (current != start && parentMap.count(current)) {
-            path.push_back(current);
-            current = parentMap.at(current);
+        size_t first = index(start.r, start.c);
+        // Parent links form a tree rooted at the start; the step bound only guards a corrupt state
+        for (size_t steps = 0; current != first && steps < cells.size(); ++steps) {
+            path.push_back(positionOf(current));
+            current -= offsets[parentCode(current)];
         }
-        if (current == start) { path.push_back(start); }
+        if (current == first) { path.push_back(start); }
         std::reverse(path.begin(), path.end());
         // Validate path integrity
         if (path.empty() || path.front() != start || path.back() != end) return {};
@@ -236,48 +686,56 @@ public:
 
     // Set dimensions, ensuring they are odd and >= 5
     bool setDimensions(int w, int h) {
-        width = (w % 2 == 0 ? w + 1 : w);
-        height = (h % 2 == 0 ? h + 1 : h);
-        if (width < 5) width = 5;
-        if (height < 5) height = 5;
+        width = oddMazeSize(w);
+        height = oddMazeSize(h);
         return true;
     }
 
     // Generate the maze using the chosen algorithm
-    void generate(int algorithm = 0) { // 0 = Backtracker, 1 = Prim's
+    void generate(int algorithm = 0) { // 0 = Backtracker, 1 = Prim's, 2 = Kruskal's, 3 = Wilson's, 4 = Eller's
         if (width <= 0 || height <= 0) {
             std::cerr << RED << "Error: Dimensions not set before generating." << RESET << std::endl;
             return;
         }
+        // Each maze gets a seed of its own, so it can be regenerated and saved with the seed
+        if (!seedPinned) seed = static_cast<uint32_t>(rng());
+        seedPinned = false; seedKnown = true;
+        rng.seed(seed);
         initializeGrid(true); // Start with a grid full of walls
-        if (algorithm == 1) {
-            generatePrims();
-        }
-        else { // Default to Recursive Backtracker
+        switch (algorithm) {
+        case 1: generatePrims(); break;
+        case 2: generateKruskal(); break;
+        case 3: generateWilson(); break;
+        case 4: generateEller(); break;
+        default: { // Default to Recursive Backtracker
             // Start carving from a random odd position
             int startR = (rng() % (height / 2)) * 2 + 1;
             int startC = (rng() % (width / 2)) * 2 + 1;
             generateRecursiveBacktracker(startR, startC);
+            break;
+        }
         }
         placeStartEnd(); // Place start/end points after carving
-        originalGrid = grid; // Save the generated state
     }
 
     // Display the maze grid in the console
     void display(const std::vector<Position>& solutionPath = {}, bool clear = true) {
         if (width <= 0 || height <= 0) return; // Don't display if not initialized
         if (clear) { std::cout << "\033[2J\033[1;1H" << std::flush; } // Clear screen (ANSI)
-        std::map<Position, bool> isSolutionPath;
-        for (const auto& p : solutionPath) { isSolutionPath[p] = true; }
+        std::vector<bool> isSolutionPath(cells.size(), false);
+        for (const auto& p : solutionPath) { isSolutionPath[index(p.r, p.c)] = true; }
         for (int r = 0; r < height; ++r) {
             for (int c = 0; c < width; ++c) {
-                Position curr = { r,c };
+                size_t i = index(r, c);
                 // If the cell is part of the solution path (and not Start/End), color it as SOLUTION
-                if (isSolutionPath[curr] && grid[r][c] != START && grid[r][c] != END) {
+                if (isSolutionPath[i] && cells[i] != START && cells[i] != END) {
                     colorCell(SOLUTION);
                 }
+                else if (!overlay.empty() && overlay[i] != 0) {
+                    colorCell(static_cast<CellType>(overlay[i])); // A search mark
+                }
                 else {
-                    colorCell(grid[r][c]); // Otherwise, use its normal cell type color
+                    colorCell(static_cast<CellType>(cells[i])); // Otherwise, use its normal cell type color
                 }
             }
             std::cout << std::endl;
@@ -285,9 +743,9 @@ public:
         std::cout << std::endl;
     }
 
-    // Restore the grid to its original state (after generation/loading)
+    // Clear the search marks; the maze itself is never modified by solving
     void restoreGrid() {
-        if (!originalGrid.empty()) grid = originalGrid;
+        if (!overlay.empty()) std::memset(overlay.data(), 0, overlay.size());
     }
 
     // Set the delay between visualization steps
@@ -297,27 +755,27 @@ public:
     }
 
     // --- SOLVING ALGORITHMS (BFS, DFS, A*) ---
-    // The internal logic of these remains the same as the previous versions.
+    // Neighbours are visited through index offsets; the sentinel border stops every search at the
+    // edge of the maze without a bounds check.
 
     std::vector<Position> solveBFS() {
         restoreGrid(); // Reset grid before solving
-        std::queue<Position> q;
-        std::map<Position, Position> parentMap;
-        std::map<Position, bool> visited;
-        q.push(start); visited[start] = true; parentMap[start] = start;
-        int dr[] = { -1,0,1,0 }; int dc[] = { 0,1,0,-1 };
+        std::queue<size_t> q;
+        SearchState state(cells.size());
+        size_t goal = index(end.r, end.c);
+        q.push(index(start.r, start.c)); state.visit(q.front());
+        std::ptrdiff_t offsets[4]; neighbourOffsets(offsets);
         std::vector<Position> path;
         while (!q.empty()) {
-            Position current = q.front(); q.pop();
-            // Mark as visited (for visualization) unless it's start/end
-            if (grid[current.r][current.c] != START && grid[current.r][current.c] != END) grid[current.r][current.c] = VISITED;
-            if (current == end) { path = reconstructPath(parentMap, end); break; } // Goal found
+            size_t i = q.front(); q.pop();
+            markVisited(i); // Mark as visited (for visualization) unless it's start/end
+            if (i == goal) { path = reconstructPath([&](size_t c) { return state.parentCode(c); }, offsets, goal); break; } // Goal found
             // Visualization step
             if (visualizationDelayMs > 0) { display(std::vector<Position>(), true); std::this_thread::sleep_for(std::chrono::milliseconds(visualizationDelayMs)); }
             // Explore neighbors
-            for (int i = 0;i < 4;++i) {
-                int nr = current.r + dr[i]; int nc = current.c + dc[i]; Position next = { nr,nc };
-                if (isValid(nr, nc) && !visited[next]) { visited[next] = true; parentMap[next] = current; q.push(next); }
+            for (int k = 0; k < 4; ++k) {
+                size_t n = i + offsets[k];
+                if (cells[n] != WALL && !state.isVisited(n)) { state.visit(n); state.setParent(n, k); q.push(n); }
             }
         }
         restoreGrid(); // Clean up VISITED markers
@@ -326,24 +784,23 @@ public:
 
     std::vector<Position> solveDFS() {
         restoreGrid();
-        std::stack<Position> s;
-        std::map<Position, Position> parentMap;
-        std::map<Position, bool> visited;
-        s.push(start); visited[start] = true; parentMap[start] = start;
-        int dr[] = { -1,0,1,0 }; int dc[] = { 0,1,0,-1 };
+        std::stack<size_t, std::vector<size_t>> s;
+        SearchState state(cells.size());
+        size_t goal = index(end.r, end.c);
+        s.push(index(start.r, start.c)); state.visit(s.top());
+        std::ptrdiff_t offsets[4]; neighbourOffsets(offsets);
         std::vector<Position> path;
         while (!s.empty()) {
-            Position current = s.top(); // Peek
-            if (current == end) { path = reconstructPath(parentMap, end); break; } // Goal found
-            // Mark as visited (for visualization)
-            if (grid[current.r][current.c] != START && grid[current.r][current.c] != END) grid[current.r][current.c] = VISITED;
+            size_t i = s.top(); // Peek
+            if (i == goal) { path = reconstructPath([&](size_t c) { return state.parentCode(c); }, offsets, goal); break; } // Goal found
+            markVisited(i); // Mark as visited (for visualization)
             // Visualization step
             if (visualizationDelayMs > 0) { display(std::vector<Position>(), true); std::this_thread::sleep_for(std::chrono::milliseconds(visualizationDelayMs)); }
             bool found_neighbor = false;
             // Explore neighbors
-            for (int i = 0;i < 4;++i) {
-                int nr = current.r + dr[i]; int nc = current.c + dc[i]; Position next = { nr,nc };
-                if (isValid(nr, nc) && !visited[next]) { visited[next] = true; parentMap[next] = current; s.push(next); found_neighbor = true; break; } // Push and break to go deep
+            for (int k = 0; k < 4; ++k) {
+                size_t n = i + offsets[k];
+                if (cells[n] != WALL && !state.isVisited(n)) { state.visit(n); state.setParent(n, k); s.push(n); found_neighbor = true; break; } // Push and break to go deep
             }
             // If no unvisited neighbor found, backtrack
             if (!found_neighbor) { s.pop(); }
@@ -356,49 +813,44 @@ public:
         restoreGrid();
         // Min-priority queue for open set
         std::priority_queue<AStarNode, std::vector<AStarNode>, std::greater<AStarNode>> openSet;
-        std::map<Position, Position> parentMap; // To reconstruct path
-        std::map<Position, int> gCost; // Cost from start to node
+        // Visited bits are the closed set and parent codes are set on closing. Manhattan distance is
+        // consistent on a unit-cost grid, so a cell's first pop already has its shortest cost and no
+        // per-cell cost array is needed; nodes carry their cost and the direction they came from.
+        SearchState state(cells.size());
 
-        // Initialize gCost for all nodes to infinity
-        // Using parentheses around max() to avoid macro issues
-        for (int r = 0;r < height;++r) for (int c = 0;c < width;++c) gCost[{r, c}] = (std::numeric_limits<int>::max)();
+        size_t goal = index(end.r, end.c);
+        openSet.push({ start, 0, heuristic(start,end), -1 }); // Add start node
 
-        gCost[start] = 0; parentMap[start] = start;
-        openSet.push({ start, 0, heuristic(start,end) }); // Add start node
-
-        int dr[] = { -1,0,1,0 }; int dc[] = { 0,1,0,-1 }; // Directions
+        std::ptrdiff_t offsets[4]; neighbourOffsets(offsets); // Directions
         std::vector<Position> path;
 
         while (!openSet.empty()) {
             AStarNode current_node = openSet.top(); // Get node with lowest fCost
             Position current_pos = current_node.pos;
             openSet.pop();
+            size_t i = index(current_pos.r, current_pos.c);
 
-            // Optional optimization: If we found a shorter path already, skip
-            // if (current_node.gCost > gCost[current_pos]) continue;
+            // A cell already closed was reached at least as cheaply before: this entry is stale
+            if (state.isVisited(i)) continue;
+            state.visit(i);
+            if (current_node.from >= 0) state.setParent(i, current_node.from);
 
-            // Mark as visited (for visualization)
-            if (grid[current_pos.r][current_pos.c] != START && grid[current_pos.r][current_pos.c] != END) grid[current_pos.r][current_pos.c] = VISITED;
+            markVisited(i); // Mark as visited (for visualization)
 
-            if (current_pos == end) { path = reconstructPath(parentMap, end); break; } // Goal found
+            if (i == goal) { path = reconstructPath([&](size_t c) { return state.parentCode(c); }, offsets, goal); break; } // Goal found
 
             // Visualization step
             if (visualizationDelayMs > 0) { display(std::vector<Position>(), true); std::this_thread::sleep_for(std::chrono::milliseconds(visualizationDelayMs)); }
 
             // Explore neighbors
-            for (int i = 0;i < 4;++i) {
-                int nr = current_pos.r + dr[i]; int nc = current_pos.c + dc[i]; Position neighbor_pos = { nr,nc };
-
-                if (isValid(nr, nc)) { // If neighbor is valid (within bounds and not a wall)
-                    int tentative_gCost = gCost[current_pos] + 1; // Cost to reach neighbor through current
-
-                    // If this path to neighbor is better than any previous one found
-                    if (tentative_gCost < gCost[neighbor_pos]) {
-                        parentMap[neighbor_pos] = current_pos; // Update parent
-                        gCost[neighbor_pos] = tentative_gCost; // Update cost
-                        int hCost = heuristic(neighbor_pos, end); // Calculate heuristic
-                        openSet.push({ neighbor_pos, tentative_gCost, hCost }); // Add/Update neighbor in open set
-                    }
+            for (int k = 0; k < 4; ++k) {
+                size_t n = i + offsets[k];
+
+                // Not a wall (the border is all walls) and not closed yet
+                if (cells[n] != WALL && !state.isVisited(n)) {
+                    Position neighbor_pos = positionOf(n);
+                    int hCost = heuristic(neighbor_pos, end); // Calculate heuristic
+                    openSet.push({ neighbor_pos, current_node.gCost + 1, hCost, k }); // Add neighbor to open set
                 }
             }
         }
@@ -406,30 +858,197 @@ public:
         return path;
     }
 
+    // Level-synchronous BFS for huge mazes. Each level's frontier is split across 'threads' workers
+    // in chunks; a worker claims a newly reached cell with a compare-and-swap on its parent code
+    // (0 = unclaimed, k + 1 = reached through offsets[k]) and keeps it in a buffer of its own, and
+    // the buffers make up the next frontier. Levels narrower than PARALLEL_LEVEL_MIN, which is
+    // nearly all of them in a perfect maze, are expanded by the calling thread alone, so the
+    // workers are only woken when there is enough work to share. Not visualized.
+    std::vector<Position> solveParallelBFS(int threads) {
+        const size_t PARALLEL_LEVEL_MIN = 2048, CHUNK = 256;
+        restoreGrid();
+        threads = (std::max)(1, threads);
+        size_t first = index(start.r, start.c), goal = index(end.r, end.c);
+        std::ptrdiff_t offsets[4]; neighbourOffsets(offsets);
+        std::unique_ptr<std::atomic<uint8_t>[]> parent(new std::atomic<uint8_t>[cells.size()]());
+        parent[first].store(1); // Claimed, so nothing is routed back through the start
+
+        // Between levels the workers synchronize through the mutex, so relaxed order suffices here
+        auto expand = [&](const size_t* from, const size_t* to, std::vector<size_t>& out) {
+            for (; from != to; ++from) {
+                for (int k = 0; k < 4; ++k) {
+                    size_t n = *from + offsets[k];
+                    if (cells[n] == WALL || parent[n].load(std::memory_order_relaxed) != 0) continue;
+                    uint8_t unclaimed = 0;
+                    if (parent[n].compare_exchange_strong(unclaimed, static_cast<uint8_t>(k + 1), std::memory_order_relaxed)) out.push_back(n);
+                }
+            }
+        };
+        std::vector<size_t> frontier = { first }, next;
+        std::vector<std::vector<size_t>> buffers(threads);
+        std::atomic<size_t> cursor(0);
+        auto work = [&](int t) {
+            buffers[t].clear();
+            for (size_t b; (b = cursor.fetch_add(CHUNK)) < frontier.size();) {
+                expand(&frontier[b], frontier.data() + (std::min)(b + CHUNK, frontier.size()), buffers[t]);
+            }
+        };
+
+        // Workers 1..threads-1 wait for a new level; the calling thread is worker 0
+        std::mutex mutex;
+        std::condition_variable wake, done;
+        size_t level = 0; int pending = 0; bool quit = false;
+        std::vector<std::thread> pool;
+        for (int t = 1; t < threads; ++t) {
+            pool.emplace_back([&, t] {
+                size_t seen = 0;
+                for (;;) {
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        wake.wait(lock, [&] { return quit || level != seen; });
+                        if (quit) return;
+                        seen = level;
+                    }
+                    work(t);
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (--pending == 0) done.notify_one();
+                }
+            });
+        }
+
+        while (!frontier.empty() && parent[goal].load(std::memory_order_relaxed) == 0) {
+            if (threads == 1 || frontier.size() < PARALLEL_LEVEL_MIN) {
+                next.clear();
+                expand(frontier.data(), frontier.data() + frontier.size(), next);
+            }
+            else {
+                cursor.store(0);
+                { std::lock_guard<std::mutex> lock(mutex); pending = threads - 1; ++level; }
+                wake.notify_all();
+                work(0);
+                { std::unique_lock<std::mutex> lock(mutex); done.wait(lock, [&] { return pending == 0; }); }
+                next.clear();
+                for (const auto& buffer : buffers) next.insert(next.end(), buffer.begin(), buffer.end());
+            }
+            frontier.swap(next);
+        }
+        { std::lock_guard<std::mutex> lock(mutex); quit = true; }
+        wake.notify_all();
+        for (auto& worker : pool) worker.join();
+
+        if (parent[goal].load() == 0) return {};
+        return reconstructPath([&](size_t c) { return parent[c].load(std::memory_order_relaxed) - 1; }, offsets, goal);
+    }
+
     // --- File I/O ---
-    bool saveToFile(const std::string& filename) const {
-        if (width <= 0 || height <= 0 || originalGrid.empty()) {
+    // Saves in the binary format (see MazeFileHeader), optionally run-length compressed
+    bool saveToFile(const std::string& filename, bool rle = false) const {
+        if (width <= 0 || height <= 0 || cells.empty()) {
             std::cerr << RED << "Error: Cannot save an uninitialized or empty maze." << RESET << std::endl;
             return false;
         }
-        std::ofstream outFile(filename);
+        std::ofstream outFile(filename, std::ios::binary);
         if (!outFile) {
             std::cerr << RED << "Error: Could not open file '" << filename << "' for writing." << RESET << std::endl;
             return false;
         }
-        outFile << width << " " << height << "\n"; // Write dimensions
-        // Write the integer value of the CellType from the *original* grid
+        BinaryRowSink sink(outFile, rle);
+        return writeRows(sink);
+    }
+
+    // Feeds the maze to a sink row by row; the rows are contiguous in the cell array. Solving never
+    // changes the cells, so these are always the generated or loaded maze.
+    bool writeRows(MazeRowSink& sink) const {
+        MazeInfo info;
+        info.width = width; info.height = height; info.start = start; info.end = end;
+        info.hasSeed = seedKnown; info.seed = seed;
+        if (!sink.begin(info)) return false;
         for (int r = 0; r < height; ++r) {
-            for (int c = 0; c < width; ++c) {
-                outFile << static_cast<int>(originalGrid[r][c]) << (c == width - 1 ? "" : " ");
-            }
-            outFile << "\n";
+            if (!sink.writeRow(&cells[index(r, 0)])) return false;
         }
-        outFile.close();
-        return !outFile.fail(); // Check if closing succeeded
+        return sink.finish();
     }
 
+    // Binary files are recognized by their magic; anything else is imported as legacy text
     bool loadFromFile(const std::string& filename) {
+        {
+            MappedFile file(filename);
+            if (file.size() >= sizeof(MazeFileHeader) && std::memcmp(file.data(), MAZE_FILE_MAGIC, sizeof(MAZE_FILE_MAGIC)) == 0) {
+                return loadBinary(file, filename);
+            }
+        }
+        return loadText(filename);
+    }
+
+private:
+    // Unpacks the mapped rows straight into the cell array; nothing is parsed
+    bool loadBinary(const MappedFile& file, const std::string& filename) {
+        MazeFileHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        auto fail = [&](const char* what) {
+            std::cerr << RED << "Error: " << what << " in maze file '" << filename << "'." << RESET << std::endl;
+            width = 0; height = 0; cells.clear(); // Invalidate maze state
+            return false;
+        };
+        const uint32_t maxSide = 1u << 30;
+        if (header.width < 5 || header.height < 5 || header.width % 2 == 0 || header.height % 2 == 0 ||
+            header.width > maxSide || header.height > maxSide || (header.flags & ~(MAZE_FILE_RLE | MAZE_FILE_SEED))) {
+            return fail("Invalid header");
+        }
+        // Check the rows can be there before allocating for them: a raw row is rowBytes long, and
+        // a run-length coded one needs at least two bytes (control and value) per 128 it expands to
+        bool rle = header.flags & MAZE_FILE_RLE;
+        size_t rowBytes = (static_cast<size_t>(header.width) + 7) / 8;
+        uint64_t minRowData = static_cast<uint64_t>(header.height) * (rle ? 2 * ((rowBytes + 127) / 128) : rowBytes);
+        if (file.size() - sizeof(header) < minRowData) return fail("Truncated row data");
+
+        width = static_cast<int>(header.width); height = static_cast<int>(header.height);
+        try {
+            initializeGrid(true);
+        }
+        catch (const std::bad_alloc&) {
+            return fail("Not enough memory for the maze");
+        }
+
+        const uint8_t* p = file.data() + sizeof(header);
+        const uint8_t* fileEnd = file.data() + file.size();
+        std::vector<uint8_t> decoded(rle ? rowBytes : 0);
+        for (int r = 0; r < height; ++r) {
+            const uint8_t* bits = p;
+            if (rle) {
+                if (!packBitsDecode(p, fileEnd, decoded.data(), rowBytes)) return fail("Corrupt or truncated row data");
+                bits = decoded.data();
+            }
+            else {
+                if (static_cast<size_t>(fileEnd - p) < rowBytes) return fail("Truncated row data");
+                p += rowBytes;
+            }
+            unpackRow(bits, &cells[index(r, 0)]);
+        }
+
+        start = { header.startR, header.startC }; end = { header.endR, header.endC };
+        if (!isValid(start.r, start.c) || !isValid(end.r, end.c) || start == end) return fail("Invalid Start or End point");
+        setCell(start.r, start.c, START);
+        setCell(end.r, end.c, END);
+        seedKnown = header.flags & MAZE_FILE_SEED;
+        seed = static_cast<uint32_t>(header.seed);
+        return true;
+    }
+
+    // Expands one packed row into cell bytes, a table lookup per eight cells
+    void unpackRow(const uint8_t* bits, uint8_t* row) const {
+        static const auto table = [] {
+            std::array<std::array<uint8_t, 8>, 256> t{};
+            for (int b = 0; b < 256; ++b) for (int j = 0; j < 8; ++j) t[b][j] = ((b >> j) & 1) ? WALL : PATH;
+            return t;
+        }();
+        int c = 0;
+        for (; c + 8 <= width; c += 8) std::memcpy(row + c, table[bits[c >> 3]].data(), 8);
+        for (; c < width; ++c) row[c] = ((bits[c >> 3] >> (c & 7)) & 1) ? WALL : PATH;
+    }
+
+    // The legacy text format, one decimal cell value per cell
+    bool loadText(const std::string& filename) {
         std::ifstream inFile(filename);
         if (!inFile) {
             std::cerr << RED << "Error: Could not open file '" << filename << "' for reading." << RESET << std::endl;
@@ -452,11 +1071,11 @@ public:
             for (int c = 0; c < width; ++c) {
                 if (!(inFile >> cellValue)) {
                     std::cerr << RED << "Error: Failed to read cell data at (" << r << "," << c << ") from file '" << filename << "'." << RESET << std::endl;
-                    inFile.close(); width = 0; height = 0; grid.clear(); // Invalidate maze state
+                    inFile.close(); width = 0; height = 0; cells.clear(); // Invalidate maze state
                     return false;
                 }
                 CellType type = static_cast<CellType>(cellValue);
-                grid[r][c] = type;
+                setCell(r, c, type);
                 // Identify start and end points during load
                 if (type == START) start = { r, c };
                 else if (type == END) end = { r, c };
@@ -466,19 +1085,25 @@ public:
         // Check if start and end points were found
         if (start.r == -1 || end.r == -1) {
             std::cerr << RED << "Error: Start or End point not found in loaded maze file '" << filename << "'." << RESET << std::endl;
-            width = 0; height = 0; grid.clear(); // Invalidate maze state
+            width = 0; height = 0; cells.clear(); // Invalidate maze state
             return false;
         }
-        originalGrid = grid; // Store the loaded state as the 'original'
+        seedKnown = false;
         return true;
     }
 
+public:
+    // Makes the next generate() use this seed; the same seed, size and algorithm give the same maze
+    void setSeed(uint32_t newSeed) { seed = newSeed; seedPinned = true; }
+
     // --- Getters ---
     Position getStart() const { return start; }
     Position getEnd() const { return end; }
     int getWidth() const { return width; }
     int getHeight() const { return height; }
-    bool isGenerated() const { return !originalGrid.empty(); } // Check if maze exists
+    bool hasSeed() const { return seedKnown; }
+    uint32_t getSeed() const { return seed; }
+    bool isGenerated() const { return !cells.empty(); } // Check if maze exists
 };
 
 // --- Utility Functions ---
@@ -496,19 +1121,134 @@ void displayAZD() {
         << "AAA         AAA  ZZZZZZZZZZZ     DDDDDDDD    \n"
         << RESET << std::endl;
 }
-// Struct to hold solving results
-struct SolveResult { std::string algoName;std::vector<Position> path;double timeMs = 0.0; };
+// Struct to hold solving results; threads is set for parallel runs, whose speedup is reported
+// against the one-thread run
+struct SolveResult { std::string algoName;std::vector<Position> path;double timeMs = 0.0;int threads = 0; };
+
+// 1, 2, 4, ... up to maxThreads, which is always included
+std::vector<int> threadCounts(int maxThreads) {
+    std::vector<int> counts;
+    for (int t = 1; t < maxThreads; t *= 2) counts.push_back(t);
+    counts.push_back((std::max)(1, maxThreads));
+    return counts;
+}
+
+int hardwareThreads() { return (std::max)(1, static_cast<int>(std::thread::hardware_concurrency())); }
+
+// Headless mode: times the parallel BFS on a maze file at 1, 2, 4, ... threads against solveBFS.
+// Each time is the best of three runs.
+int runBfsScaling(const std::vector<std::string>& args) {
+    if (args.empty()) {
+        std::cerr << "Usage: MazeSolver --bfs-scaling <maze file> [max threads]" << std::endl;
+        return 1;
+    }
+    Maze maze;
+    maze.setVisualizationDelay(0);
+    if (!maze.loadFromFile(args[0])) return 1;
+    int maxThreads = args.size() > 1 ? (std::max)(1, std::atoi(args[1].c_str())) : hardwareThreads();
+    auto bestOf3 = [](auto solve, size_t& length) {
+        double best = 0.0;
+        for (int run = 0; run < 3; ++run) {
+            auto t1 = std::chrono::high_resolution_clock::now();
+            length = solve().size();
+            std::chrono::duration<double, std::milli> ms_double = std::chrono::high_resolution_clock::now() - t1;
+            if (run == 0 || ms_double.count() < best) best = ms_double.count();
+        }
+        return best;
+    };
+    size_t length = 0;
+    double sequentialMs = bestOf3([&] { return maze.solveBFS(); }, length);
+    std::cout << maze.getWidth() << "x" << maze.getHeight() << " maze, path length " << length << std::endl;
+    std::cout << std::fixed << std::setprecision(3) << "solveBFS: " << sequentialMs << " ms" << std::endl;
+    double oneThreadMs = 0.0;
+    for (int t : threadCounts(maxThreads)) {
+        double ms = bestOf3([&] { return maze.solveParallelBFS(t); }, length);
+        if (t == 1) oneThreadMs = ms;
+        std::cout << std::setprecision(3) << "parallel BFS, " << t << " thread" << (t == 1 ? ": " : "s: ") << ms << " ms, path length "
+            << length << ", speedup " << std::setprecision(2) << oneThreadMs / ms << "x (" << sequentialMs / ms << "x vs solveBFS)" << std::endl;
+    }
+    return 0;
+}
+
+
+// Headless mode: streams an Eller's-algorithm maze to a file, or to stdout for "-" or no path, in
+// the binary format (run-length compressed with --rle) or, with --text, the legacy text format.
+int runStreamEller(const std::vector<std::string>& args, uint32_t seed, bool text, bool rle) {
+    if (args.size() < 2) {
+        std::cerr << "Usage: MazeSolver --stream-eller <width> <height> [output|-] [--seed N] [--rle | --text]" << std::endl;
+        return 1;
+    }
+    int w = oddMazeSize(std::atoi(args[0].c_str()));
+    int h = oddMazeSize(std::atoi(args[1].c_str()));
+    std::string outPath = args.size() > 2 ? args[2] : "-";
+    std::ofstream outFile;
+    if (outPath == "-") {
+        std::ios_base::sync_with_stdio(false);
+#ifdef _WIN32
+        // Text-mode stdout would turn every 0x0A byte of a binary maze into CR LF
+        if (!text) _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    }
+    else {
+        outFile.open(outPath, std::ios::binary);
+        if (!outFile) {
+            std::cerr << RED << "Error: Could not open file '" << outPath << "' for writing." << RESET << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = (outPath == "-") ? std::cout : outFile;
+    TextRowSink textSink(out);
+    BinaryRowSink binarySink(out, rle);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    bool ok = text ? streamEllerMaze(w, h, seed, textSink) : streamEllerMaze(w, h, seed, binarySink);
+    std::chrono::duration<double, std::milli> ms_double = std::chrono::high_resolution_clock::now() - t1;
+    if (!ok) {
+        std::cerr << RED << "Error: Writing the maze failed." << RESET << std::endl;
+        return 1;
+    }
+    // Progress goes to stderr so stdout carries only the maze
+    std::cerr << "Streamed " << w << "x" << h << " maze (seed " << seed << ") in " << std::fixed << std::setprecision(3)
+        << ms_double.count() << " ms (" << std::setprecision(0) << double(w) * h / (std::max)(ms_double.count(), 1e-3) * 1000.0
+        << " cells/s)." << std::endl;
+    return 0;
+}
 
 
 // --- Main Application Logic ---
-int main() {
+int main(int argc, char* argv[]) {
     // Set console output to UTF-8 on Windows
 #ifdef _WIN32
     SetConsoleOutputCP(CP_UTF8); // 65001
     // May also need for input: SetConsoleCP(CP_UTF8);
 #endif
 
+    uint32_t seed = std::random_device{}();
+    bool seedGiven = false, textOutput = false, rleOutput = false;
+    std::string mode;
+    std::vector<std::string> modeArgs;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            seedGiven = true;
+        }
+        else if (arg == "--text") {
+            textOutput = true;
+        }
+        else if (arg == "--rle") {
+            rleOutput = true;
+        }
+        else if (arg == "--stream-eller" || arg == "--bfs-scaling") {
+            mode = arg;
+            // Mode arguments run up to the next option; a lone "-" is an argument (stdout)
+            while (i + 1 < argc && (argv[i + 1][0] != '-' || argv[i + 1][1] == '\0')) modeArgs.push_back(argv[++i]);
+        }
+    }
+    if (mode == "--stream-eller") return runStreamEller(modeArgs, seed, textOutput, rleOutput);
+    if (mode == "--bfs-scaling") return runBfsScaling(modeArgs);
+
     Maze maze;
+    if (seedGiven) maze.setSeed(seed); // For the first maze generated
     int delay = 10; // Default visualization delay
     bool mazeLoadedOrGenerated = false; // Track if a maze is ready
 
@@ -554,18 +1294,23 @@ int main() {
                 if (std::cin.fail() || h < 5) { std::cout << RED << "Invalid input.\n" << RESET; std::cin.clear(); std::cin.ignore((std::numeric_limits<std::streamsize>::max)(), '\n'); h = 0; }
             }
             // Get generation algorithm choice
-            while (algoChoice < 1 || algoChoice > 2) {
-                std::cout << BLUE << "Generation Algorithm (1: Backtracker, 2: Prim's): " << RESET;
+            while (algoChoice < 1 || algoChoice > 5) {
+                std::cout << BLUE << "Generation Algorithm (1: Backtracker, 2: Prim's, 3: Kruskal's, 4: Wilson's, 5: Eller's): " << RESET;
                 std::cin >> algoChoice;
-                if (std::cin.fail() || algoChoice < 1 || algoChoice > 2) { std::cout << RED << "Invalid choice.\n" << RESET; std::cin.clear(); std::cin.ignore((std::numeric_limits<std::streamsize>::max)(), '\n'); algoChoice = 0; }
+                if (std::cin.fail() || algoChoice < 1 || algoChoice > 5) { std::cout << RED << "Invalid choice.\n" << RESET; std::cin.clear(); std::cin.ignore((std::numeric_limits<std::streamsize>::max)(), '\n'); algoChoice = 0; }
             }
             std::cin.ignore((std::numeric_limits<std::streamsize>::max)(), '\n'); // Clear newline
 
             maze.setDimensions(w, h);
-            std::cout << YELLOW << "Generating maze using " << (algoChoice == 1 ? "Recursive Backtracker" : "Prim's Algorithm") << "..." << RESET << std::endl;
-            maze.generate(algoChoice - 1); // Pass 0 for Backtracker, 1 for Prim's
+            const char* algoNames[] = { "Recursive Backtracker", "Prim's Algorithm", "Kruskal's Algorithm", "Wilson's Algorithm", "Eller's Algorithm" };
+            std::cout << YELLOW << "Generating maze using " << algoNames[algoChoice - 1] << "..." << RESET << std::endl;
+            auto t1 = std::chrono::high_resolution_clock::now();
+            maze.generate(algoChoice - 1); // Pass 0 for Backtracker, 1 for Prim's, ...
+            std::chrono::duration<double, std::milli> ms_double = std::chrono::high_resolution_clock::now() - t1;
             mazeLoadedOrGenerated = true;
-            std::cout << GREEN << "Maze generated. Displaying:" << RESET << std::endl;
+            double cellCount = static_cast<double>(maze.getWidth()) * maze.getHeight();
+            std::cout << GREEN << "Maze generated in " << std::fixed << std::setprecision(3) << ms_double.count() << " ms ("
+                << std::setprecision(0) << cellCount / (std::max)(ms_double.count(), 1e-3) * 1000.0 << " cells/s, seed " << maze.getSeed() << "). Displaying:" << RESET << std::endl;
             std::this_thread::sleep_for(std::chrono::milliseconds(200));
             maze.display();
             break;
@@ -592,15 +1337,16 @@ int main() {
             }
             // Get solving algorithm choice
             int solveChoice = 0;
-            while (solveChoice < 1 || solveChoice > 4) {
+            while (solveChoice < 1 || solveChoice > 5) {
                 std::cout << BLUE << "\nChoose solving algorithm:\n";
                 std::cout << "1. Breadth-First Search (BFS - Shortest Path)\n";
                 std::cout << "2. Depth-First Search (DFS)\n";
                 std::cout << "3. A* Search (Heuristic - Shortest Path)\n";
                 std::cout << "4. Run and Compare All\n";
-                std::cout << "Enter your choice (1-4): " << RESET;
+                std::cout << "5. Parallel BFS (Speedup vs Thread Count)\n";
+                std::cout << "Enter your choice (1-5): " << RESET;
                 std::cin >> solveChoice;
-                if (std::cin.fail() || solveChoice < 1 || solveChoice > 4) { std::cout << RED << "Invalid choice.\n" << RESET; std::cin.clear(); std::cin.ignore((std::numeric_limits<std::streamsize>::max)(), '\n'); solveChoice = 0; }
+                if (std::cin.fail() || solveChoice < 1 || solveChoice > 5) { std::cout << RED << "Invalid choice.\n" << RESET; std::cin.clear(); std::cin.ignore((std::numeric_limits<std::streamsize>::max)(), '\n'); solveChoice = 0; }
             }
             std::cin.ignore((std::numeric_limits<std::streamsize>::max)(), '\n'); // Clear newline
 
@@ -636,6 +1382,14 @@ int main() {
                 if (solveChoice != 4) std::cout << GREEN << "A* Finished." << RESET << std::endl;
                 std::this_thread::sleep_for(std::chrono::milliseconds(500));
             }
+            if (solveChoice == 5) {
+                for (int t : threadCounts(hardwareThreads())) {
+                    std::cout << YELLOW << "\nSolving using parallel BFS with " << t << " thread(s)..." << RESET << std::endl;
+                    t1 = std::chrono::high_resolution_clock::now(); auto p = maze.solveParallelBFS(t); t2 = std::chrono::high_resolution_clock::now();
+                    ms_double = t2 - t1; results.push_back({ "Parallel BFS (" + std::to_string(t) + " threads)", p, ms_double.count(), t });
+                }
+                maze.display(results.back().path, true);
+            }
 
             // Display Summary of Results
             std::cout << "\n--- Solver Results ---" << std::endl;
@@ -644,6 +1398,9 @@ int main() {
                 if (!r.path.empty()) {
                     std::cout << GREEN << "  Path found! " << RESET
                         << "Length: " << r.path.size() << " steps. Time: " << std::fixed << std::setprecision(3) << r.timeMs << " ms." << std::endl;
+                    if (r.threads > 0) { // Parallel runs start at one thread
+                        std::cout << "  Speedup vs 1 thread: " << std::setprecision(2) << results.front().timeMs / (std::max)(r.timeMs, 1e-6) << "x" << std::endl;
+                    }
                 }
                 else {
                     std::cout << RED << "  Path not found. " << RESET
@@ -664,7 +1421,11 @@ int main() {
             std::string filename;
             std::cout << BLUE << "Enter filename to save: " << RESET;
             std::getline(std::cin, filename);
-            if (maze.saveToFile(filename)) {
+            std::string answer;
+            std::cout << BLUE << "Run-length compress the file? (y/N): " << RESET;
+            std::getline(std::cin, answer);
+            bool rle = !answer.empty() && (answer[0] == 'y' || answer[0] == 'Y');
+            if (maze.saveToFile(filename, rle)) {
                 std::cout << GREEN << "Maze saved successfully to '" << filename << "'." << RESET << std::endl;
             }
             else {
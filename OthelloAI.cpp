@@ -2,10 +2,17 @@
 
 #ifdef _WIN32
 #include <windows.h> 
+#else
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
 #include <iostream>
 #include <vector>
+#include <array>
 #include <string>
 #include <algorithm> 
 #include <limits>    
@@ -13,6 +20,26 @@
 #include <thread>    
 #include <iomanip>   
 #include <random>    
+#include <sstream>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+#include <cstdlib>
+#include <cctype>
+#include <cstring>
+#include <cmath>
+#include <fstream>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 const int BOARD_SIZE = 8;
 enum class PlayerColor { NONE, BLACK, WHITE };
@@ -34,6 +61,520 @@ struct Move {
     bool operator==(const Move& other) const { return row == other.row && col == other.col; }
 };
 
+// Square (r, c) is bit r * 8 + c; a position is one 64-bit mask per colour.
+namespace Bitboard {
+    const uint64_t NOT_EDGE_COLUMNS = 0x7e7e7e7e7e7e7e7eULL;
+
+    inline uint64_t squareBit(int row, int col) { return 1ULL << (row * BOARD_SIZE + col); }
+
+    inline int popCount(uint64_t b) {
+#if defined(_MSC_VER)
+        return static_cast<int>(__popcnt64(b));
+#else
+        return __builtin_popcountll(b);
+#endif
+    }
+
+    inline int firstSquare(uint64_t b) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, b);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(b);
+#endif
+    }
+
+#if defined(__AVX2__)
+    // The eight directions as four shift amounts (E/W, S/N, SW/NE, SE/NW), one per 64-bit lane,
+    // each shifted both left and right.
+    inline __m256i directionShifts() { return _mm256_set_epi64x(9, 7, 8, 1); }
+    inline __m256i directionMasks(uint64_t opponent) {
+        return _mm256_and_si256(_mm256_set1_epi64x(static_cast<long long>(opponent)),
+            _mm256_set_epi64x(NOT_EDGE_COLUMNS, NOT_EDGE_COLUMNS, ~0ULL, NOT_EDGE_COLUMNS));
+    }
+    inline uint64_t orLanes(__m256i v) {
+        __m128i x = _mm_or_si128(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        x = _mm_or_si128(x, _mm_unpackhi_epi64(x, x));
+        return static_cast<uint64_t>(_mm_cvtsi128_si64(x));
+    }
+
+    inline uint64_t legalMoves(uint64_t player, uint64_t opponent) {
+        const __m256i shift = directionShifts();
+        const __m256i shift2 = _mm256_add_epi64(shift, shift);
+        const __m256i mask = directionMasks(opponent);
+        const __m256i p = _mm256_set1_epi64x(static_cast<long long>(player));
+
+        __m256i flipL = _mm256_and_si256(mask, _mm256_sllv_epi64(p, shift));
+        __m256i flipR = _mm256_and_si256(mask, _mm256_srlv_epi64(p, shift));
+        flipL = _mm256_or_si256(flipL, _mm256_and_si256(mask, _mm256_sllv_epi64(flipL, shift)));
+        flipR = _mm256_or_si256(flipR, _mm256_and_si256(mask, _mm256_srlv_epi64(flipR, shift)));
+        __m256i preL = _mm256_and_si256(mask, _mm256_sllv_epi64(mask, shift));
+        __m256i preR = _mm256_and_si256(mask, _mm256_srlv_epi64(mask, shift));
+        flipL = _mm256_or_si256(flipL, _mm256_and_si256(preL, _mm256_sllv_epi64(flipL, shift2)));
+        flipR = _mm256_or_si256(flipR, _mm256_and_si256(preR, _mm256_srlv_epi64(flipR, shift2)));
+        flipL = _mm256_or_si256(flipL, _mm256_and_si256(preL, _mm256_sllv_epi64(flipL, shift2)));
+        flipR = _mm256_or_si256(flipR, _mm256_and_si256(preR, _mm256_srlv_epi64(flipR, shift2)));
+
+        __m256i moves = _mm256_or_si256(_mm256_sllv_epi64(flipL, shift), _mm256_srlv_epi64(flipR, shift));
+        return orLanes(moves) & ~(player | opponent);
+    }
+
+    inline uint64_t flips(int square, uint64_t player, uint64_t opponent) {
+        const __m256i shift = directionShifts();
+        const __m256i shift2 = _mm256_add_epi64(shift, shift);
+        const __m256i shift4 = _mm256_add_epi64(shift2, shift2);
+        const __m256i p = _mm256_set1_epi64x(static_cast<long long>(player));
+        const __m256i move = _mm256_set1_epi64x(static_cast<long long>(1ULL << square));
+
+        // Kogge-Stone occluded fill from the move square through opponent discs.
+        __m256i proL = directionMasks(opponent), proR = proL;
+        __m256i genL = move, genR = move;
+        genL = _mm256_or_si256(genL, _mm256_and_si256(proL, _mm256_sllv_epi64(genL, shift)));
+        genR = _mm256_or_si256(genR, _mm256_and_si256(proR, _mm256_srlv_epi64(genR, shift)));
+        proL = _mm256_and_si256(proL, _mm256_sllv_epi64(proL, shift));
+        proR = _mm256_and_si256(proR, _mm256_srlv_epi64(proR, shift));
+        genL = _mm256_or_si256(genL, _mm256_and_si256(proL, _mm256_sllv_epi64(genL, shift2)));
+        genR = _mm256_or_si256(genR, _mm256_and_si256(proR, _mm256_srlv_epi64(genR, shift2)));
+        proL = _mm256_and_si256(proL, _mm256_sllv_epi64(proL, shift2));
+        proR = _mm256_and_si256(proR, _mm256_srlv_epi64(proR, shift2));
+        genL = _mm256_or_si256(genL, _mm256_and_si256(proL, _mm256_sllv_epi64(genL, shift4)));
+        genR = _mm256_or_si256(genR, _mm256_and_si256(proR, _mm256_srlv_epi64(genR, shift4)));
+
+        // A run only flips if the square just past it holds one of the player's discs.
+        __m256i zero = _mm256_setzero_si256();
+        __m256i closedL = _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_sllv_epi64(genL, shift), p), zero);
+        __m256i closedR = _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_srlv_epi64(genR, shift), p), zero);
+        __m256i result = _mm256_or_si256(_mm256_andnot_si256(closedL, genL), _mm256_andnot_si256(closedR, genR));
+        return orLanes(result) & opponent;
+    }
+#else
+    inline uint64_t shiftLeft(uint64_t b, int n) { return b << n; }
+    inline uint64_t shiftRight(uint64_t b, int n) { return b >> n; }
+
+    inline uint64_t movesInDirection(uint64_t player, uint64_t mask, int dir) {
+        uint64_t flipL = mask & (player << dir);
+        uint64_t flipR = mask & (player >> dir);
+        flipL |= mask & (flipL << dir);
+        flipR |= mask & (flipR >> dir);
+        uint64_t preL = mask & (mask << dir);
+        uint64_t preR = mask & (mask >> dir);
+        flipL |= preL & (flipL << (dir * 2));
+        flipR |= preR & (flipR >> (dir * 2));
+        flipL |= preL & (flipL << (dir * 2));
+        flipR |= preR & (flipR >> (dir * 2));
+        return (flipL << dir) | (flipR >> dir);
+    }
+
+    inline uint64_t legalMoves(uint64_t player, uint64_t opponent) {
+        uint64_t inner = opponent & NOT_EDGE_COLUMNS;
+        uint64_t moves = movesInDirection(player, inner, 1) | movesInDirection(player, opponent, 8)
+            | movesInDirection(player, inner, 7) | movesInDirection(player, inner, 9);
+        return moves & ~(player | opponent);
+    }
+
+    template <uint64_t (*Shift)(uint64_t, int)>
+    inline uint64_t flipsInDirection(uint64_t move, uint64_t player, uint64_t mask, int dir) {
+        uint64_t gen = move, pro = mask;
+        gen |= pro & Shift(gen, dir);
+        pro &= Shift(pro, dir);
+        gen |= pro & Shift(gen, dir * 2);
+        pro &= Shift(pro, dir * 2);
+        gen |= pro & Shift(gen, dir * 4);
+        return (Shift(gen, dir) & player) ? (gen & ~move) : 0;
+    }
+
+    inline uint64_t flips(int square, uint64_t player, uint64_t opponent) {
+        uint64_t move = 1ULL << square;
+        uint64_t inner = opponent & NOT_EDGE_COLUMNS;
+        return flipsInDirection<shiftLeft>(move, player, inner, 1) | flipsInDirection<shiftRight>(move, player, inner, 1)
+            | flipsInDirection<shiftLeft>(move, player, opponent, 8) | flipsInDirection<shiftRight>(move, player, opponent, 8)
+            | flipsInDirection<shiftLeft>(move, player, inner, 7) | flipsInDirection<shiftRight>(move, player, inner, 7)
+            | flipsInDirection<shiftLeft>(move, player, inner, 9) | flipsInDirection<shiftRight>(move, player, inner, 9);
+    }
+#endif
+
+    const uint64_t FILE_A = 0x0101010101010101ULL;
+    const uint64_t FILE_H = 0x8080808080808080ULL;
+    const uint64_t RANK_1 = 0x00000000000000FFULL;
+    const uint64_t RANK_8 = 0xFF00000000000000ULL;
+    const uint64_t CORNERS = 0x8100000000000081ULL;
+
+    // The 15 diagonals and 15 anti-diagonals, for finding full lines.
+    struct DiagonalMasks {
+        uint64_t diagonal[2 * BOARD_SIZE - 1] = {};
+        uint64_t antiDiagonal[2 * BOARD_SIZE - 1] = {};
+
+        DiagonalMasks() {
+            for (int sq = 0; sq < BOARD_SIZE * BOARD_SIZE; ++sq) {
+                int r = sq / BOARD_SIZE, c = sq % BOARD_SIZE;
+                diagonal[r - c + BOARD_SIZE - 1] |= 1ULL << sq;
+                antiDiagonal[r + c] |= 1ULL << sq;
+            }
+        }
+    };
+    const DiagonalMasks diagonalMasks;
+
+    // Squares whose whole line is occupied, one mask per direction: rows, columns, diagonals
+    // (A1-H8 direction) and anti-diagonals. Nothing along a full line can ever flip.
+    inline void fullLines(uint64_t occupied, uint64_t full[4]) {
+        full[0] = 0;
+        for (int r = 0; r < BOARD_SIZE; ++r) {
+            if (((occupied >> (r * BOARD_SIZE)) & RANK_1) == RANK_1) full[0] |= RANK_1 << (r * BOARD_SIZE);
+        }
+        // AND each square with the rest of its column by rotating whole rows around.
+        uint64_t column = occupied;
+        column &= (column >> 32) | (column << 32);
+        column &= (column >> 16) | (column << 48);
+        column &= (column >> 8) | (column << 56);
+        full[1] = column;
+        full[2] = full[3] = 0;
+        for (int d = 0; d < 2 * BOARD_SIZE - 1; ++d) {
+            if ((occupied & diagonalMasks.diagonal[d]) == diagonalMasks.diagonal[d]) full[2] |= diagonalMasks.diagonal[d];
+            if ((occupied & diagonalMasks.antiDiagonal[d]) == diagonalMasks.antiDiagonal[d]) full[3] |= diagonalMasks.antiDiagonal[d];
+        }
+    }
+
+    // Discs of 'player' that can never be flipped. Along each of the four lines through it, a
+    // stable disc either sits on a full line or touches the board edge or another of the player's
+    // stable discs; the set grows from the corners until nothing changes. This is a lower bound:
+    // some discs that are in fact stable (e.g. protected by the opponent's stable discs) are missed.
+    inline uint64_t stableDiscs(uint64_t player, uint64_t opponent) {
+        // Without a corner or a full edge the only seeds would be discs on four full lines, which
+        // hardly occur before the last few moves; skip the work.
+        uint64_t occupied = player | opponent;
+        if ((player & CORNERS) == 0 && (occupied & RANK_1) != RANK_1 && (occupied & RANK_8) != RANK_8 &&
+            (occupied & FILE_A) != FILE_A && (occupied & FILE_H) != FILE_H) {
+            return 0;
+        }
+        uint64_t full[4];
+        fullLines(occupied, full);
+        uint64_t stable = 0, previous;
+        do {
+            previous = stable;
+            uint64_t horizontal = full[0] | (stable << 1) | (stable >> 1) | FILE_A | FILE_H;
+            uint64_t vertical = full[1] | (stable << 8) | (stable >> 8) | RANK_1 | RANK_8;
+            uint64_t diagonal = full[2] | (stable << 9) | (stable >> 9) | FILE_A | FILE_H | RANK_1 | RANK_8;
+            uint64_t antiDiagonal = full[3] | (stable << 7) | (stable >> 7) | FILE_A | FILE_H | RANK_1 | RANK_8;
+            stable = player & horizontal & vertical & diagonal & antiDiagonal;
+        } while (stable != previous);
+        return stable;
+    }
+
+    inline uint64_t flipVertical(uint64_t b) {
+        b = ((b >> 8) & 0x00FF00FF00FF00FFULL) | ((b & 0x00FF00FF00FF00FFULL) << 8);
+        b = ((b >> 16) & 0x0000FFFF0000FFFFULL) | ((b & 0x0000FFFF0000FFFFULL) << 16);
+        return (b >> 32) | (b << 32);
+    }
+
+    inline uint64_t mirrorHorizontal(uint64_t b) {
+        b = ((b >> 1) & 0x5555555555555555ULL) | ((b & 0x5555555555555555ULL) << 1);
+        b = ((b >> 2) & 0x3333333333333333ULL) | ((b & 0x3333333333333333ULL) << 2);
+        return ((b >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((b & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    }
+
+    // Swaps rows and columns.
+    inline uint64_t transpose(uint64_t b) {
+        uint64_t t;
+        t = 0x0F0F0F0F00000000ULL & (b ^ (b << 28)); b ^= t ^ (t >> 28);
+        t = 0x3333000033330000ULL & (b ^ (b << 14)); b ^= t ^ (t >> 14);
+        t = 0x5500550055005500ULL & (b ^ (b << 7)); b ^= t ^ (t >> 7);
+        return b;
+    }
+
+    // The eight symmetries of the board: bit 0 mirrors the columns, bit 1 the rows, and bit 2
+    // then swaps rows and columns.
+    inline uint64_t transform(uint64_t b, int symmetry) {
+        if (symmetry & 1) b = mirrorHorizontal(b);
+        if (symmetry & 2) b = flipVertical(b);
+        if (symmetry & 4) b = transpose(b);
+        return b;
+    }
+
+    inline int transformSquare(int square, int symmetry) {
+        int r = square / BOARD_SIZE, c = square % BOARD_SIZE;
+        if (symmetry & 1) c = BOARD_SIZE - 1 - c;
+        if (symmetry & 2) r = BOARD_SIZE - 1 - r;
+        if (symmetry & 4) std::swap(r, c);
+        return r * BOARD_SIZE + c;
+    }
+}
+
+// Boards of other even sizes, 4x4 to 10x10: one bit per square, numbered row by row, in a 64-bit
+// mask while the board fits and in two words beyond that.
+namespace Bitboard {
+    struct Bits128 {
+        uint64_t lo = 0, hi = 0;
+
+        constexpr Bits128() = default;
+        constexpr Bits128(uint64_t low, uint64_t high = 0) : lo(low), hi(high) {}
+
+        constexpr Bits128 operator&(Bits128 o) const { return { lo & o.lo, hi & o.hi }; }
+        constexpr Bits128 operator|(Bits128 o) const { return { lo | o.lo, hi | o.hi }; }
+        constexpr Bits128 operator^(Bits128 o) const { return { lo ^ o.lo, hi ^ o.hi }; }
+        constexpr Bits128 operator~() const { return { ~lo, ~hi }; }
+        constexpr Bits128 operator<<(int n) const {
+            return (n == 0) ? *this : (n >= 64) ? Bits128(0, lo << (n - 64)) : Bits128(lo << n, (hi << n) | (lo >> (64 - n)));
+        }
+        constexpr Bits128 operator>>(int n) const {
+            return (n == 0) ? *this : (n >= 64) ? Bits128(hi >> (n - 64), 0) : Bits128((lo >> n) | (hi << (64 - n)), hi >> n);
+        }
+        Bits128& operator&=(Bits128 o) { return *this = *this & o; }
+        Bits128& operator|=(Bits128 o) { return *this = *this | o; }
+        Bits128& operator^=(Bits128 o) { return *this = *this ^ o; }
+        constexpr bool operator==(Bits128 o) const { return lo == o.lo && hi == o.hi; }
+        constexpr bool operator!=(Bits128 o) const { return !(*this == o); }
+        constexpr explicit operator bool() const { return (lo | hi) != 0; }
+    };
+
+    inline int popCount(Bits128 b) { return popCount(b.lo) + popCount(b.hi); }
+    inline int firstSquare(Bits128 b) { return b.lo ? firstSquare(b.lo) : 64 + firstSquare(b.hi); }
+    inline uint64_t withoutFirst(uint64_t b) { return b & (b - 1); }
+    inline Bits128 withoutFirst(Bits128 b) { return b.lo ? Bits128(b.lo & (b.lo - 1), b.hi) : Bits128(0, b.hi & (b.hi - 1)); }
+}
+
+// Masks, square weights and move generation for an NxN board. The move generator is the same
+// Kogge-Stone style fill as Bitboard's scalar path, run for as many steps as the longest possible
+// line needs.
+template<int N>
+struct GenericBoardGeometry {
+    static_assert(N >= 4 && N % 2 == 0 && N * N <= 128, "board must be even-sized and fit in 128 bits");
+    using Bits = typename std::conditional<(N * N <= 64), uint64_t, Bitboard::Bits128>::type;
+    static constexpr int SQUARES = N * N;
+
+    static constexpr Bits bit(int square) { return Bits(1) << square; }
+    static constexpr bool test(Bits b, int square) { return static_cast<bool>(b & bit(square)); }
+
+    static constexpr Bits columnsMask(bool keepEdges) {
+        Bits mask = Bits(0);
+        for (int sq = 0; sq < SQUARES; ++sq) {
+            if (keepEdges || (sq % N != 0 && sq % N != N - 1)) mask = mask | bit(sq);
+        }
+        return mask;
+    }
+    static constexpr Bits ALL = columnsMask(true);
+    static constexpr Bits NOT_EDGE_COLUMNS = columnsMask(false);
+
+    // Corners, then X- and C-squares next to them, then the other edge squares.
+    static constexpr int squareWeight(int square) {
+        int dr = std::min(square / N, N - 1 - square / N);
+        int dc = std::min(square % N, N - 1 - square % N);
+        if (dr == 0 && dc == 0) return 500;
+        if (dr == 1 && dc == 1) return -250;
+        if (dr + dc == 1) return -150;
+        if (dr == 0 || dc == 0) return 20;
+        return (dr == 1 || dc == 1) ? 0 : 2;
+    }
+    static constexpr std::array<int, SQUARES> makeSquareWeights() {
+        std::array<int, SQUARES> weights{};
+        for (int sq = 0; sq < SQUARES; ++sq) weights[sq] = squareWeight(sq);
+        return weights;
+    }
+    static constexpr std::array<int, SQUARES> SQUARE_WEIGHTS = makeSquareWeights();
+
+    static Bits movesInDirection(Bits player, Bits mask, int dir) {
+        Bits flipL = mask & (player << dir);
+        Bits flipR = mask & (player >> dir);
+        for (int i = 0; i < N - 3; ++i) {
+            flipL |= mask & (flipL << dir);
+            flipR |= mask & (flipR >> dir);
+        }
+        return (flipL << dir) | (flipR >> dir);
+    }
+
+    static Bits legalMoves(Bits player, Bits opponent) {
+        Bits inner = opponent & NOT_EDGE_COLUMNS;
+        Bits moves = movesInDirection(player, inner, 1) | movesInDirection(player, opponent, N)
+            | movesInDirection(player, inner, N - 1) | movesInDirection(player, inner, N + 1);
+        return moves & ~(player | opponent) & ALL;
+    }
+
+    static Bits flipsInDirection(Bits move, Bits player, Bits mask, int dir) {
+        Bits runL = mask & (move << dir);
+        Bits runR = mask & (move >> dir);
+        for (int i = 0; i < N - 3; ++i) {
+            runL |= mask & (runL << dir);
+            runR |= mask & (runR >> dir);
+        }
+        // A run only flips if the square just past it holds one of the player's discs.
+        return (((runL << dir) & player) ? runL : Bits(0)) | (((runR >> dir) & player) ? runR : Bits(0));
+    }
+
+    static Bits flips(int square, Bits player, Bits opponent) {
+        Bits move = bit(square);
+        Bits inner = opponent & NOT_EDGE_COLUMNS;
+        return flipsInDirection(move, player, inner, 1) | flipsInDirection(move, player, opponent, N)
+            | flipsInDirection(move, player, inner, N - 1) | flipsInDirection(move, player, inner, N + 1);
+    }
+};
+
+template<int N>
+struct BoardGeometry : GenericBoardGeometry<N> {};
+
+// 8x8 uses Bitboard's move generator, with its AVX2 path, and the hand-tuned square table that
+// also seeds the pattern weights.
+template<>
+struct BoardGeometry<BOARD_SIZE> : GenericBoardGeometry<BOARD_SIZE> {
+    static constexpr std::array<int, BOARD_SIZE * BOARD_SIZE> SQUARE_WEIGHTS = {
+         500, -150, 30, 10, 10, 30, -150,  500,
+        -150, -250,  0,  0,  0,  0, -250, -150,
+          30,    0,  1,  2,  2,  1,    0,   30,
+          10,    0,  2, 16, 16,  2,    0,   10,
+          10,    0,  2, 16, 16,  2,    0,   10,
+          30,    0,  1,  2,  2,  1,    0,   30,
+        -150, -250,  0,  0,  0,  0, -250, -150,
+         500, -150, 30, 10, 10, 30, -150,  500
+    };
+    static uint64_t legalMoves(uint64_t player, uint64_t opponent) { return Bitboard::legalMoves(player, opponent); }
+    static uint64_t flips(int square, uint64_t player, uint64_t opponent) { return Bitboard::flips(square, player, opponent); }
+};
+
+// Random keys for incremental position hashing: one per square and colour, plus one for the side to move.
+namespace Zobrist {
+    template<int N>
+    struct Keys {
+        uint64_t disc[2][N * N];
+        uint64_t flip[N * N]; // disc[0] ^ disc[1], toggles a square's colour
+        uint64_t whiteToMove;
+
+        Keys() {
+            std::mt19937_64 gen(0x5eed0fbadcafe123ULL);
+            for (int sq = 0; sq < N * N; ++sq) {
+                disc[0][sq] = gen();
+                disc[1][sq] = gen();
+                flip[sq] = disc[0][sq] ^ disc[1][sq];
+            }
+            whiteToMove = gen();
+        }
+    };
+    const Keys<BOARD_SIZE> keys;
+
+    // Other board sizes get theirs on first use.
+    template<int N>
+    inline const Keys<N>& keysFor() {
+        static const Keys<N> instance;
+        return instance;
+    }
+    template<>
+    inline const Keys<BOARD_SIZE>& keysFor<BOARD_SIZE>() { return keys; }
+
+    inline uint64_t discKey(PlayerColor player, int square) {
+        return keys.disc[player == PlayerColor::BLACK ? 0 : 1][square];
+    }
+}
+
+// Pattern evaluation. Lines of squares (edges, corners, rows, columns, diagonals) are read as
+// base-3 numbers (0 empty, 1 black, 2 white) and each number indexes a weight table for its
+// pattern type and game stage. The board keeps every index up to date as discs are placed and
+// flipped, so evaluating a position is one table lookup per pattern.
+namespace Patterns {
+    enum Type { EDGE_2X, CORNER_3X3, CORNER_2X5, LINE_2, LINE_3, LINE_4, DIAG_8, DIAG_7, DIAG_6, DIAG_5, DIAG_4, TYPE_COUNT };
+    const int INSTANCE_COUNT = 46;
+    const int STAGE_COUNT = 8;
+    const int MAX_PATTERNS_PER_SQUARE = 12;
+
+    struct SquareUpdate {
+        uint8_t instance;
+        uint16_t power;
+    };
+
+    struct Geometry {
+        Type typeOf[INSTANCE_COUNT];
+        int firstInstance[TYPE_COUNT];
+        // Weight tables of one stage lie back to back; these are the offsets into such a block.
+        int typeOffset[TYPE_COUNT];
+        int instanceOffset[INSTANCE_COUNT];
+        int stageSize = 0;
+        std::vector<int> squares[INSTANCE_COUNT];
+        SquareUpdate updates[BOARD_SIZE * BOARD_SIZE][MAX_PATTERNS_PER_SQUARE];
+        int updateCount[BOARD_SIZE * BOARD_SIZE] = {};
+
+        Geometry() {
+            // One orientation of each pattern, as (row, col) pairs; the others are its images
+            // under the eight symmetries of the board.
+            const std::vector<std::vector<std::pair<int, int>>> shapes = {
+                { {0,0}, {0,1}, {0,2}, {0,3}, {0,4}, {0,5}, {0,6}, {0,7}, {1,1}, {1,6} },
+                { {0,0}, {0,1}, {0,2}, {1,0}, {1,1}, {1,2}, {2,0}, {2,1}, {2,2} },
+                { {0,0}, {0,1}, {0,2}, {0,3}, {0,4}, {1,0}, {1,1}, {1,2}, {1,3}, {1,4} },
+                { {1,0}, {1,1}, {1,2}, {1,3}, {1,4}, {1,5}, {1,6}, {1,7} },
+                { {2,0}, {2,1}, {2,2}, {2,3}, {2,4}, {2,5}, {2,6}, {2,7} },
+                { {3,0}, {3,1}, {3,2}, {3,3}, {3,4}, {3,5}, {3,6}, {3,7} },
+                { {0,0}, {1,1}, {2,2}, {3,3}, {4,4}, {5,5}, {6,6}, {7,7} },
+                { {0,1}, {1,2}, {2,3}, {3,4}, {4,5}, {5,6}, {6,7} },
+                { {0,2}, {1,3}, {2,4}, {3,5}, {4,6}, {5,7} },
+                { {0,3}, {1,4}, {2,5}, {3,6}, {4,7} },
+                { {0,4}, {1,5}, {2,6}, {3,7} },
+            };
+            int instance = 0;
+            std::vector<std::vector<int>> seen;
+            for (int type = 0; type < TYPE_COUNT; ++type) {
+                firstInstance[type] = instance;
+                for (int symmetry = 0; symmetry < 8; ++symmetry) {
+                    std::vector<int> squaresOfInstance;
+                    for (auto rc : shapes[type]) {
+                        int r = rc.first, c = rc.second;
+                        if (symmetry & 1) c = BOARD_SIZE - 1 - c;
+                        if (symmetry & 2) r = BOARD_SIZE - 1 - r;
+                        if (symmetry & 4) std::swap(r, c);
+                        squaresOfInstance.push_back(r * BOARD_SIZE + c);
+                    }
+                    std::vector<int> sorted = squaresOfInstance;
+                    std::sort(sorted.begin(), sorted.end());
+                    if (std::find(seen.begin(), seen.end(), sorted) != seen.end()) continue;
+                    seen.push_back(sorted);
+                    typeOf[instance] = static_cast<Type>(type);
+                    squares[instance] = squaresOfInstance;
+                    int power = 1;
+                    for (int sq : squaresOfInstance) {
+                        updates[sq][updateCount[sq]++] = { static_cast<uint8_t>(instance), static_cast<uint16_t>(power) };
+                        power *= 3;
+                    }
+                    instance++;
+                }
+            }
+            for (int type = 0; type < TYPE_COUNT; ++type) {
+                typeOffset[type] = stageSize;
+                int size = 1;
+                for (size_t i = 0; i < squares[firstInstance[type]].size(); ++i) size *= 3;
+                stageSize += size;
+            }
+            for (int i = 0; i < INSTANCE_COUNT; ++i) {
+                instanceOffset[i] = typeOffset[typeOf[i]];
+            }
+        }
+    };
+    const Geometry geometry;
+
+    inline int tableSize(Type type) {
+        int next = (type + 1 < TYPE_COUNT) ? geometry.typeOffset[type + 1] : geometry.stageSize;
+        return next - geometry.typeOffset[type];
+    }
+
+    inline int stageOf(int discCount) {
+        return std::min(STAGE_COUNT - 1, std::max(0, (discCount - 4) / 8));
+    }
+
+    // Weights are from Black's point of view.
+    struct Weights {
+        std::vector<int16_t> values = std::vector<int16_t>(static_cast<size_t>(STAGE_COUNT) * geometry.stageSize);
+        int16_t mobility[STAGE_COUNT] = {};
+        // Per stable disc (Bitboard::stableDiscs) more than the opponent has.
+        int16_t stability[STAGE_COUNT] = {};
+
+        int16_t* table(int stage, Type type) { return values.data() + stage * geometry.stageSize + geometry.typeOffset[type]; }
+    };
+    Weights& weights();
+
+    inline int evaluate(const uint16_t* indices, int stage) {
+        const int16_t* stageWeights = weights().values.data() + stage * geometry.stageSize;
+        int score = 0;
+        for (int i = 0; i < INSTANCE_COUNT; ++i) {
+            score += stageWeights[geometry.instanceOffset[i] + indices[i]];
+        }
+        return score;
+    }
+}
+
 namespace Console {
     const std::string RESET = "\033[0m";
     const std::string FG_BLACK = "\033[30m";
@@ -129,258 +670,1787 @@ namespace Console {
 }
 
 
-class Board {
+// Pattern indices are only kept on the 8x8 board, the one the pattern tables are for.
+template<int N> struct BoardPatternIndices {};
+template<> struct BoardPatternIndices<BOARD_SIZE> {
+    uint16_t patternIndex[Patterns::INSTANCE_COUNT];
+};
+
+// An NxN position. 8x8 is the game itself, evaluated by the pattern tables; the other sizes share
+// its move generation, hashing and search, and evaluate by square weights and mobility.
+template<int N>
+class BasicBoard : public BoardPatternIndices<N> {
 public:
-    std::vector<std::vector<Piece>> grid;
-    const std::vector<std::vector<int>> pieceSquareTable = {
-        { 500, -150, 30, 10, 10, 30, -150,  500},
-        {-150, -250,  0,  0,  0,  0, -250, -150},
-        {  30,    0,  1,  2,  2,  1,    0,   30},
-        {  10,    0,  2, 16, 16,  2,    0,   10},
-        {  10,    0,  2, 16, 16,  2,    0,   10},
-        {  30,    0,  1,  2,  2,  1,    0,   30},
-        {-150, -250,  0,  0,  0,  0, -250, -150},
-        { 500, -150, 30, 10, 10, 30, -150,  500}
-    };
-
-    Board() : grid(BOARD_SIZE, std::vector<Piece>(BOARD_SIZE, Piece::EMPTY)) {
-        grid[3][3] = Piece::WHITE_PIECE;
-        grid[3][4] = Piece::BLACK_PIECE;
-        grid[4][3] = Piece::BLACK_PIECE;
-        grid[4][4] = Piece::WHITE_PIECE;
-    }
-    Board(const Board& other) : grid(other.grid) {}
+    using G = BoardGeometry<N>;
+    using Bits = typename G::Bits;
+
+    Bits blackDiscs;
+    Bits whiteDiscs;
+    uint64_t hash;
+
+    BasicBoard() :
+        blackDiscs(G::bit((N / 2 - 1) * N + N / 2) | G::bit((N / 2) * N + N / 2 - 1)),
+        whiteDiscs(G::bit((N / 2 - 1) * N + N / 2 - 1) | G::bit((N / 2) * N + N / 2)) {
+        hash = computeHash();
+        computePatternIndices();
+    }
+    BasicBoard(const BasicBoard& other) = default;
+    BasicBoard& operator=(const BasicBoard& other) = default;
 
     bool isWithinBounds(int r, int c) const {
-        return r >= 0 && r < BOARD_SIZE && c >= 0 && c < BOARD_SIZE;
+        return r >= 0 && r < N && c >= 0 && c < N;
     }
 
-    std::vector<Move> getFlipsForMove(int r_start, int c_start, PlayerColor player) const {
-        std::vector<Move> allFlips;
-        if (!isWithinBounds(r_start, c_start) || grid[r_start][c_start] != Piece::EMPTY) {
-            return allFlips;
-        }
-
-        Piece playerPiece = playerToPiece(player);
-        Piece opponentPiece = playerToPiece(getOpponent(player));
+    Piece at(int r, int c) const {
+        Bits bit = G::bit(r * N + c);
+        if (blackDiscs & bit) return Piece::BLACK_PIECE;
+        if (whiteDiscs & bit) return Piece::WHITE_PIECE;
+        return Piece::EMPTY;
+    }
 
-        for (int dr = -1; dr <= 1; ++dr) {
-            for (int dc = -1; dc <= 1; ++dc) {
-                if (dr == 0 && dc == 0) continue;
+    void setDiscs(Bits black, Bits white) {
+        blackDiscs = black;
+        whiteDiscs = white;
+        hash = computeHash();
+        computePatternIndices();
+    }
 
-                int r = r_start + dr;
-                int c = c_start + dc;
-                std::vector<Move> currentLineFlips;
+    uint64_t computeHash() const {
+        uint64_t h = 0;
+        for (Bits b = blackDiscs; b; b = Bitboard::withoutFirst(b)) h ^= keys().disc[0][Bitboard::firstSquare(b)];
+        for (Bits b = whiteDiscs; b; b = Bitboard::withoutFirst(b)) h ^= keys().disc[1][Bitboard::firstSquare(b)];
+        return h;
+    }
 
-                while (isWithinBounds(r, c) && grid[r][c] == opponentPiece) {
-                    currentLineFlips.push_back({ r, c });
-                    r += dr;
-                    c += dc;
-                }
-                if (isWithinBounds(r, c) && grid[r][c] == playerPiece && !currentLineFlips.empty()) {
-                    allFlips.insert(allFlips.end(), currentLineFlips.begin(), currentLineFlips.end());
+    void computePatternIndices() {
+        if constexpr (N == BOARD_SIZE) {
+            for (int i = 0; i < Patterns::INSTANCE_COUNT; ++i) {
+                int index = 0;
+                const std::vector<int>& squares = Patterns::geometry.squares[i];
+                for (int j = static_cast<int>(squares.size()) - 1; j >= 0; --j) {
+                    uint64_t bit = 1ULL << squares[j];
+                    index = index * 3 + ((blackDiscs & bit) ? 1 : (whiteDiscs & bit) ? 2 : 0);
                 }
+                this->patternIndex[i] = static_cast<uint16_t>(index);
             }
         }
-        return allFlips;
     }
 
-    std::vector<Move> getValidMoves(PlayerColor player) const {
-        std::vector<Move> validMoves;
-        for (int r = 0; r < BOARD_SIZE; ++r) {
-            for (int c = 0; c < BOARD_SIZE; ++c) {
-                if (grid[r][c] == Piece::EMPTY) {
-                    if (!getFlipsForMove(r, c, player).empty()) {
-                        validMoves.push_back({ r, c });
-                    }
-                }
+    // Moves the pattern indices of 'square' by 'digitDelta' times the square's place value.
+    void updatePatterns(int square, int digitDelta) {
+        const Patterns::SquareUpdate* updates = Patterns::geometry.updates[square];
+        for (int i = 0; i < Patterns::geometry.updateCount[square]; ++i) {
+            this->patternIndex[updates[i].instance] = static_cast<uint16_t>(this->patternIndex[updates[i].instance] + digitDelta * updates[i].power);
+        }
+    }
+
+    // Placing a disc adds its digit (1 black, 2 white); a flip to black is -1 and a flip to white +1.
+    void updatePatternsForMove(int square, PlayerColor player, Bits flipped, int direction) {
+        if constexpr (N == BOARD_SIZE) {
+            int sign = (player == PlayerColor::BLACK) ? 1 : -1;
+            updatePatterns(square, direction * (player == PlayerColor::BLACK ? 1 : 2));
+            for (; flipped; flipped &= flipped - 1) {
+                updatePatterns(Bitboard::firstSquare(flipped), -direction * sign);
             }
         }
-        return validMoves;
+    }
+
+    uint64_t hashFor(PlayerColor sideToMove) const {
+        return hash ^ (sideToMove == PlayerColor::WHITE ? keys().whiteToMove : 0);
+    }
+
+    Bits discsOf(PlayerColor player) const {
+        return (player == PlayerColor::BLACK) ? blackDiscs : whiteDiscs;
+    }
+
+    Bits emptySquares() const {
+        return G::ALL & ~(blackDiscs | whiteDiscs);
+    }
+
+    Bits getValidMoveMask(PlayerColor player) const {
+        return G::legalMoves(discsOf(player), discsOf(getOpponent(player)));
+    }
+
+    Bits getFlipMask(int r, int c, PlayerColor player) const {
+        if (!isWithinBounds(r, c) || !(emptySquares() & G::bit(r * N + c))) return Bits(0);
+        return G::flips(r * N + c, discsOf(player), discsOf(getOpponent(player)));
+    }
+
+    std::vector<Move> getFlipsForMove(int r_start, int c_start, PlayerColor player) const {
+        return toMoves(getFlipMask(r_start, c_start, player));
+    }
+
+    std::vector<Move> getValidMoves(PlayerColor player) const {
+        return toMoves(getValidMoveMask(player));
     }
 
     void applyMove(Move move, PlayerColor player, const std::vector<Move>& flips) {
-        grid[move.row][move.col] = playerToPiece(player);
+        Bits changed = Bits(0);
         for (const auto& p : flips) {
-            grid[p.row][p.col] = playerToPiece(player);
+            changed |= G::bit(p.row * N + p.col);
         }
+        Bits placed = G::bit(move.row * N + move.col);
+        if (player == PlayerColor::BLACK) {
+            blackDiscs |= changed | placed;
+            whiteDiscs &= ~changed;
+        }
+        else {
+            whiteDiscs |= changed | placed;
+            blackDiscs &= ~changed;
+        }
+        hash = computeHash();
+        computePatternIndices();
     }
 
-    std::pair<int, int> getScore() const {
-        int blackScore = 0;
-        int whiteScore = 0;
-        for (int r = 0; r < BOARD_SIZE; ++r) {
-            for (int c = 0; c < BOARD_SIZE; ++c) {
-                if (grid[r][c] == Piece::BLACK_PIECE) blackScore++;
-                else if (grid[r][c] == Piece::WHITE_PIECE) whiteScore++;
-            }
+    void toggleHash(int square, PlayerColor player, Bits flipped) {
+        hash ^= keys().disc[player == PlayerColor::BLACK ? 0 : 1][square];
+        for (; flipped; flipped = Bitboard::withoutFirst(flipped)) {
+            hash ^= keys().flip[Bitboard::firstSquare(flipped)];
+        }
+    }
+
+    // In-place move for the search: returns the flipped discs so that undoMove can restore the position.
+    Bits makeMove(int square, PlayerColor player) {
+        Bits flipped = G::flips(square, discsOf(player), discsOf(getOpponent(player)));
+        Bits placed = G::bit(square);
+        if (player == PlayerColor::BLACK) {
+            blackDiscs |= flipped | placed;
+            whiteDiscs ^= flipped;
+        }
+        else {
+            whiteDiscs |= flipped | placed;
+            blackDiscs ^= flipped;
+        }
+        toggleHash(square, player, flipped);
+        updatePatternsForMove(square, player, flipped, 1);
+        return flipped;
+    }
+
+    void undoMove(int square, PlayerColor player, Bits flipped) {
+        Bits placed = G::bit(square);
+        if (player == PlayerColor::BLACK) {
+            blackDiscs &= ~(flipped | placed);
+            whiteDiscs |= flipped;
+        }
+        else {
+            whiteDiscs &= ~(flipped | placed);
+            blackDiscs |= flipped;
         }
-        return { blackScore, whiteScore };
+        toggleHash(square, player, flipped);
+        updatePatternsForMove(square, player, flipped, -1);
+    }
+
+    std::pair<int, int> getScore() const {
+        return { Bitboard::popCount(blackDiscs), Bitboard::popCount(whiteDiscs) };
     }
 
     bool isGameOver() const {
-        return getValidMoves(PlayerColor::BLACK).empty() && getValidMoves(PlayerColor::WHITE).empty();
+        return !getValidMoveMask(PlayerColor::BLACK) && !getValidMoveMask(PlayerColor::WHITE);
     }
 
+    // From the point of view of 'player'. On 8x8 the pattern score plus mobility and stable discs;
+    // on other sizes square weights plus mobility, and finished games score the disc difference
+    // past any heuristic value.
     int evaluate(PlayerColor player) const {
         PlayerColor opponent = getOpponent(player);
-        Piece playerPiece = playerToPiece(player);
-        Piece opponentPiece = playerToPiece(opponent);
+        int playerDiscs = Bitboard::popCount(discsOf(player));
+        int opponentDiscs = Bitboard::popCount(discsOf(opponent));
+        int playerMoves = Bitboard::popCount(getValidMoveMask(player));
+        int opponentMoves = Bitboard::popCount(getValidMoveMask(opponent));
+
+        if constexpr (N != BOARD_SIZE) {
+            if (playerMoves + opponentMoves == 0) {
+                int diff = playerDiscs - opponentDiscs;
+                return (diff > 0) ? WIN_SCORE + diff : (diff < 0) ? -WIN_SCORE + diff : 0;
+            }
+            int score = MOBILITY_WEIGHT * (playerMoves - opponentMoves);
+            for (Bits b = discsOf(player); b; b = Bitboard::withoutFirst(b)) score += G::SQUARE_WEIGHTS[Bitboard::firstSquare(b)];
+            for (Bits b = discsOf(opponent); b; b = Bitboard::withoutFirst(b)) score -= G::SQUARE_WEIGHTS[Bitboard::firstSquare(b)];
+            return score;
+        }
+        else {
+            int totalDiscs = playerDiscs + opponentDiscs;
+            int stage = Patterns::stageOf(totalDiscs);
+            int heuristicScore = Patterns::evaluate(this->patternIndex, stage);
+            if (player == PlayerColor::WHITE) heuristicScore = -heuristicScore;
+
+            if (playerMoves + opponentMoves != 0) {
+                heuristicScore += Patterns::weights().mobility[stage] * (playerMoves - opponentMoves);
+                int stabilityWeight = Patterns::weights().stability[stage];
+                if (stabilityWeight != 0) {
+                    uint64_t mine = discsOf(player), theirs = discsOf(opponent);
+                    heuristicScore += stabilityWeight * (Bitboard::popCount(Bitboard::stableDiscs(mine, theirs)) -
+                        Bitboard::popCount(Bitboard::stableDiscs(theirs, mine)));
+                }
+            }
+            else {
+                if (playerDiscs > opponentDiscs) heuristicScore += 20000;
+                else if (opponentDiscs > playerDiscs) heuristicScore -= 20000;
+            }
+
+            if (playerDiscs == 0 && playerMoves == 0 && totalDiscs > 4) return -50000;
+            if (opponentDiscs == 0 && opponentMoves == 0 && totalDiscs > 4) return 50000;
 
-        int heuristicScore = 0;
+            return heuristicScore;
+        }
+    }
 
-        int playerDiscs = 0;
-        int opponentDiscs = 0;
-        int playerPieceSquareScore = 0;
-        int opponentPieceSquareScore = 0;
+    static const int WIN_SCORE = 20000;
+    static const int MOBILITY_WEIGHT = 50;
 
-        for (int r = 0; r < BOARD_SIZE; ++r) {
-            for (int c = 0; c < BOARD_SIZE; ++c) {
-                if (grid[r][c] == playerPiece) {
-                    playerDiscs++;
-                    playerPieceSquareScore += pieceSquareTable[r][c];
+private:
+    static const Zobrist::Keys<N>& keys() { return Zobrist::keysFor<N>(); }
+
+    static std::vector<Move> toMoves(Bits mask) {
+        std::vector<Move> moves;
+        moves.reserve(Bitboard::popCount(mask));
+        for (; mask; mask = Bitboard::withoutFirst(mask)) {
+            int sq = Bitboard::firstSquare(mask);
+            moves.push_back({ sq / N, sq % N });
+        }
+        return moves;
+    }
+};
+using Board = BasicBoard<BOARD_SIZE>;
+
+
+namespace Patterns {
+    // Seeds the tables from the hand-tuned heuristic: each square's table value, disc weight and
+    // corner bonus are split evenly between the patterns that cover it. On top of that, X- and
+    // C-squares lose their penalty once the corner next to them is taken, which a square table
+    // cannot express.
+    inline Weights makeDefaultWeights() {
+        const int CORNER_BONUS = 800;
+        const int MOBILITY_WEIGHT = 50;
+        const int STABILITY_WEIGHT = 40;
+        Weights w;
+        for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+            w.mobility[stage] = MOBILITY_WEIGHT;
+            w.stability[stage] = STABILITY_WEIGHT;
+            int midStageDiscs = 8 + 8 * stage;
+            int discWeight = (midStageDiscs > 48) ? 100 : (midStageDiscs < 16) ? 5 : 15;
+            for (int type = 0; type < TYPE_COUNT; ++type) {
+                const std::vector<int>& squares = geometry.squares[geometry.firstInstance[type]];
+                int n = static_cast<int>(squares.size());
+                std::vector<double> share(n), guardedShare(n);
+                std::vector<int> guardingCorner(n, -1);
+                for (int j = 0; j < n; ++j) {
+                    int r = squares[j] / BOARD_SIZE, c = squares[j] % BOARD_SIZE;
+                    int cornerRow = (r < BOARD_SIZE / 2) ? 0 : BOARD_SIZE - 1;
+                    int cornerCol = (c < BOARD_SIZE / 2) ? 0 : BOARD_SIZE - 1;
+                    bool isCorner = (r == cornerRow && c == cornerCol);
+                    int squareValue = BoardGeometry<BOARD_SIZE>::SQUARE_WEIGHTS[squares[j]];
+                    double coverage = geometry.updateCount[squares[j]];
+                    share[j] = (squareValue + discWeight + (isCorner ? CORNER_BONUS : 0)) / coverage;
+                    guardedShare[j] = share[j];
+                    if (!isCorner && squareValue < 0 && std::abs(r - cornerRow) <= 1 && std::abs(c - cornerCol) <= 1) {
+                        auto corner = std::find(squares.begin(), squares.end(), cornerRow * BOARD_SIZE + cornerCol);
+                        if (corner != squares.end()) {
+                            guardingCorner[j] = static_cast<int>(corner - squares.begin());
+                            guardedShare[j] = discWeight / coverage;
+                        }
+                    }
                 }
-                else if (grid[r][c] == opponentPiece) {
-                    opponentDiscs++;
-                    opponentPieceSquareScore += pieceSquareTable[r][c];
+                int16_t* table = w.table(stage, static_cast<Type>(type));
+                int size = tableSize(static_cast<Type>(type));
+                std::vector<int> digits(n);
+                for (int index = 0; index < size; ++index) {
+                    for (int j = 0, rest = index; j < n; ++j, rest /= 3) digits[j] = rest % 3;
+                    double value = 0.0;
+                    for (int j = 0; j < n; ++j) {
+                        if (digits[j] == 0) continue;
+                        bool guarded = guardingCorner[j] >= 0 && digits[guardingCorner[j]] != 0;
+                        double v = guarded ? guardedShare[j] : share[j];
+                        value += (digits[j] == 1) ? v : -v;
+                    }
+                    table[index] = static_cast<int16_t>(std::lround(value));
                 }
             }
         }
-        heuristicScore += (playerPieceSquareScore - opponentPieceSquareScore);
+        return w;
+    }
+
+    Weights& weights() {
+        static Weights w = makeDefaultWeights();
+        return w;
+    }
+
+    // Weights file written by --train: magic, stage count and entries per stage (so a file from a
+    // different pattern set is rejected), then the int16 tables and the per-stage mobility and
+    // stability weights. Version 1 files have no stability weights; they load with those at zero.
+    const char WEIGHTS_MAGIC[8] = { 'O', 'T', 'H', 'W', 'G', 'T', 'S', '2' };
+    const char WEIGHTS_MAGIC_V1[8] = { 'O', 'T', 'H', 'W', 'G', 'T', 'S', '1' };
+
+    inline bool saveWeights(const Weights& w, const std::string& path) {
+        std::ofstream file(path, std::ios::binary);
+        if (!file) return false;
+        uint32_t shape[2] = { static_cast<uint32_t>(STAGE_COUNT), static_cast<uint32_t>(geometry.stageSize) };
+        file.write(WEIGHTS_MAGIC, sizeof(WEIGHTS_MAGIC));
+        file.write(reinterpret_cast<const char*>(shape), sizeof(shape));
+        file.write(reinterpret_cast<const char*>(w.values.data()), w.values.size() * sizeof(int16_t));
+        file.write(reinterpret_cast<const char*>(w.mobility), sizeof(w.mobility));
+        file.write(reinterpret_cast<const char*>(w.stability), sizeof(w.stability));
+        return static_cast<bool>(file);
+    }
+
+    inline bool loadWeights(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return false;
+        char magic[sizeof(WEIGHTS_MAGIC)];
+        uint32_t shape[2];
+        if (!file.read(magic, sizeof(magic))) return false;
+        bool hasStability = std::equal(magic, magic + sizeof(magic), WEIGHTS_MAGIC);
+        if (!hasStability && !std::equal(magic, magic + sizeof(magic), WEIGHTS_MAGIC_V1)) return false;
+        if (!file.read(reinterpret_cast<char*>(shape), sizeof(shape)) ||
+            shape[0] != static_cast<uint32_t>(STAGE_COUNT) || shape[1] != static_cast<uint32_t>(geometry.stageSize)) return false;
+        Weights loaded;
+        file.read(reinterpret_cast<char*>(loaded.values.data()), loaded.values.size() * sizeof(int16_t));
+        file.read(reinterpret_cast<char*>(loaded.mobility), sizeof(loaded.mobility));
+        if (hasStability) file.read(reinterpret_cast<char*>(loaded.stability), sizeof(loaded.stability));
+        if (!file) return false;
+        weights() = std::move(loaded);
+        return true;
+    }
+}
+
+const int SCORE_INFINITY = 1000000;
+
+// Fixed-size hash table of searched positions, indexed by Zobrist key. Entries from older searches
+// are always replaced; within one search deeper results win. Search threads share one table without
+// locks: each bucket stores its data word and key ^ data, so a torn write just reads as a miss.
+class TranspositionTable {
+public:
+    enum Bound : uint8_t { EXACT, LOWER_BOUND, UPPER_BOUND };
+    struct Entry {
+        uint64_t key = 0;
+        int32_t score = 0;
+        int8_t depth = -1;
+        uint8_t bound = EXACT;
+        int8_t bestMove = -1;
+        uint8_t generation = 0;
+    };
+
+    explicit TranspositionTable(size_t sizeMb = 16) {
+        size_t count = 1;
+        while (count * 2 * sizeof(Bucket) <= sizeMb * 1024 * 1024) count *= 2;
+        buckets = std::vector<Bucket>(count);
+        indexMask = count - 1;
+    }
+
+    void newSearch() { generation++; }
+
+    void clear() {
+        for (Bucket& b : buckets) {
+            b.check.store(0, std::memory_order_relaxed);
+            b.data.store(0, std::memory_order_relaxed);
+        }
+        generation = 0;
+    }
 
-        int discDiffWeight = 15;
-        size_t totalDiscs = static_cast<size_t>(playerDiscs) + opponentDiscs;
-        if (totalDiscs > BOARD_SIZE * BOARD_SIZE * 0.75) {
-            discDiffWeight = 100;
+    bool probe(uint64_t key, Entry& out) const {
+        const Bucket& b = buckets[key & indexMask];
+        uint64_t data = b.data.load(std::memory_order_relaxed);
+        if ((b.check.load(std::memory_order_relaxed) ^ data) != key) return false;
+        out.key = key;
+        out.score = static_cast<int32_t>(static_cast<uint32_t>(data));
+        out.depth = static_cast<int8_t>(data >> 32);
+        out.bound = static_cast<uint8_t>(data >> 40);
+        out.bestMove = static_cast<int8_t>(data >> 48);
+        out.generation = static_cast<uint8_t>(data >> 56);
+        return out.depth >= 0;
+    }
+
+    void store(uint64_t key, int depth, int score, Bound bound, int bestMove) {
+        Entry old;
+        bool sameKey = probe(key, old);
+        if (!sameKey) {
+            const Bucket& b = buckets[key & indexMask];
+            uint64_t data = b.data.load(std::memory_order_relaxed);
+            if (static_cast<uint8_t>(data >> 56) == generation && static_cast<int8_t>(data >> 32) > depth) return;
         }
-        else if (totalDiscs < BOARD_SIZE * BOARD_SIZE * 0.25) {
-            discDiffWeight = 5;
+        else if (bestMove < 0) {
+            bestMove = old.bestMove;
         }
-        heuristicScore += (playerDiscs - opponentDiscs) * discDiffWeight;
+        uint64_t data = static_cast<uint32_t>(score)
+            | static_cast<uint64_t>(static_cast<uint8_t>(depth)) << 32
+            | static_cast<uint64_t>(bound) << 40
+            | static_cast<uint64_t>(static_cast<uint8_t>(bestMove)) << 48
+            | static_cast<uint64_t>(generation) << 56;
+        Bucket& b = buckets[key & indexMask];
+        b.data.store(data, std::memory_order_relaxed);
+        b.check.store(key ^ data, std::memory_order_relaxed);
+    }
 
-        int playerCorners = 0, opponentCorners = 0;
-        const int CORNER_BONUS = 800;
-        if (grid[0][0] == playerPiece) playerCorners++; else if (grid[0][0] == opponentPiece) opponentCorners++;
-        if (grid[0][BOARD_SIZE - 1] == playerPiece) playerCorners++; else if (grid[0][BOARD_SIZE - 1] == opponentPiece) opponentCorners++;
-        if (grid[BOARD_SIZE - 1][0] == playerPiece) playerCorners++; else if (grid[BOARD_SIZE - 1][0] == opponentPiece) opponentCorners++;
-        if (grid[BOARD_SIZE - 1][BOARD_SIZE - 1] == playerPiece) playerCorners++; else if (grid[BOARD_SIZE - 1][BOARD_SIZE - 1] == opponentPiece) opponentCorners++;
-        heuristicScore += (playerCorners - opponentCorners) * CORNER_BONUS;
-
-        size_t playerMoves = getValidMoves(player).size();
-        size_t opponentMoves = getValidMoves(opponent).size();
-        const int MOBILITY_WEIGHT = 50;
+private:
+    struct Bucket {
+        std::atomic<uint64_t> check{ 0 };
+        std::atomic<uint64_t> data{ 0 };
+    };
+    std::vector<Bucket> buckets;
+    size_t indexMask = 0;
+    uint8_t generation = 0;
+};
 
-        if (playerMoves + opponentMoves != 0) {
-            heuristicScore += MOBILITY_WEIGHT * (static_cast<int>(playerMoves) - static_cast<int>(opponentMoves));
+// Work-stealing thread pool. Every thread owns a deque: it pushes and pops its own tasks at the back
+// and, when idle, steals the oldest task from another thread. Slot 0 belongs to whichever thread
+// drives the search; it helps with queued work while it waits for a split point to finish.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(int threadCount) : slots(std::max(1, threadCount)) {
+        for (int i = 1; i < static_cast<int>(slots.size()); ++i) {
+            workers.emplace_back([this, i] { workerLoop(i); });
         }
-        else {
-            if (playerDiscs > opponentDiscs) heuristicScore += 20000;
-            else if (opponentDiscs > playerDiscs) heuristicScore -= 20000;
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            stopping = true;
         }
+        wake.notify_all();
+        for (auto& w : workers) w.join();
+    }
+
+    int size() const { return static_cast<int>(slots.size()); }
 
-        if (playerDiscs == 0 && playerMoves == 0 && totalDiscs > 4) return -50000;
-        if (opponentDiscs == 0 && opponentMoves == 0 && totalDiscs > 4) return 50000;
+    int currentSlot() const { return (threadPool == this) ? threadSlot : 0; }
+
+    void submit(std::function<void()> task) {
+        Slot& slot = slots[currentSlot()];
+        {
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            slot.tasks.push_back(std::move(task));
+        }
+        queuedTasks.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+        }
+        wake.notify_one();
+    }
+
+    // Runs one queued task, own work first. Returns false if there was nothing to do.
+    bool runPendingTask() {
+        int self = currentSlot();
+        std::function<void()> task;
+        for (int i = 0; i < size() && !task; ++i) {
+            Slot& slot = slots[(self + i) % size()];
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            if (slot.tasks.empty()) continue;
+            if (i == 0) {
+                task = std::move(slot.tasks.back());
+                slot.tasks.pop_back();
+            }
+            else {
+                task = std::move(slot.tasks.front());
+                slot.tasks.pop_front();
+            }
+        }
+        if (!task) return false;
+        queuedTasks.fetch_sub(1);
+        task();
+        return true;
+    }
 
-        return heuristicScore;
+private:
+    struct Slot {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+    std::vector<Slot> slots;
+    std::vector<std::thread> workers;
+    std::atomic<int> queuedTasks{ 0 };
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    static thread_local const WorkStealingPool* threadPool;
+    static thread_local int threadSlot;
+
+    void workerLoop(int slot) {
+        threadPool = this;
+        threadSlot = slot;
+        while (true) {
+            if (runPendingTask()) continue;
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait(lock, [this] { return stopping || queuedTasks.load() > 0; });
+            if (stopping) return;
+        }
+    }
+};
+thread_local const WorkStealingPool* WorkStealingPool::threadPool = nullptr;
+thread_local int WorkStealingPool::threadSlot = 0;
+
+// Shared state of a node whose younger brothers are being searched in parallel. A beta cutoff
+// here cancels every search below it, including those of nested split points.
+struct SplitPoint {
+    const SplitPoint* parent;
+    int alpha, beta;
+    int bestScore, bestSquare;
+    std::mutex mutex;
+    std::atomic<bool> cutoff{ false };
+    std::atomic<int> pending{ 0 };
+
+    SplitPoint(const SplitPoint* parentSplit, int a, int b, int score, int square)
+        : parent(parentSplit), alpha(a), beta(b), bestScore(score), bestSquare(square) {
+    }
+    bool cancelled() const {
+        for (const SplitPoint* sp = this; sp; sp = sp->parent) {
+            if (sp->cutoff.load(std::memory_order_relaxed)) return true;
+        }
+        return false;
     }
 };
 
-class AIPlayer {
+// Transposition table of the endgame solver: proven bounds on the final score, with the best
+// move and the number of empties, four entries to a cache-line bucket. When a bucket is full,
+// the entry with the fewest empties, the cheapest to find again, makes way. Like
+// TranspositionTable it needs no locks: an entry holds key ^ data and data, so a torn write, from
+// another thread or from a run killed halfway through writing a mapped file, just reads as a miss.
+// The buckets are the table's own, or memory the caller keeps alive, such as a memory-mapped file.
+class EndgameTable {
 public:
+    static const int BUCKET_ENTRIES = 4;
+    struct Entry {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> data;
+    };
+    struct Bucket {
+        Entry entries[BUCKET_ENTRIES];
+    };
+    static_assert(sizeof(Bucket) == 64, "a bucket is one cache line");
+
+    explicit EndgameTable(size_t sizeMb = 4) { allocate(sizeMb); }
+    EndgameTable(const EndgameTable&) = delete;
+    EndgameTable& operator=(const EndgameTable&) = delete;
+
+    // The largest power of two of buckets that fits in 'sizeMb'.
+    static uint64_t bucketCountFor(size_t sizeMb) {
+        uint64_t count = 1;
+        while (count * 2 * sizeof(Bucket) <= sizeMb * 1024 * 1024) count *= 2;
+        return count;
+    }
+
+    void allocate(size_t sizeMb) {
+        owned = std::vector<Bucket>(bucketCountFor(sizeMb));
+        buckets = owned.data();
+        bucketMask = owned.size() - 1;
+    }
+
+    // Uses 'count' buckets (a power of two) at 'memory' from now on, leaving their contents as they are.
+    void attach(Bucket* memory, uint64_t count) {
+        owned = std::vector<Bucket>();
+        buckets = memory;
+        bucketMask = count - 1;
+    }
+
+    void clear() {
+        for (uint64_t i = 0; i <= bucketMask; ++i) {
+            for (Entry& e : buckets[i].entries) {
+                e.check.store(0, std::memory_order_relaxed);
+                e.data.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t bytes() const { return (bucketMask + 1) * sizeof(Bucket); }
+
+    static uint64_t keyOf(uint64_t player, uint64_t opponent) {
+        uint64_t h = player * 0x9E3779B97F4A7C15ULL ^ (opponent + 0x632BE59BD9B4E019ULL) * 0xC2B2AE3D27D4EB4FULL;
+        return h ^ (h >> 29);
+    }
+
+    bool probe(uint64_t key, int& lower, int& upper, int& bestMove) const {
+        const Bucket& bucket = buckets[key & bucketMask];
+        for (const Entry& e : bucket.entries) {
+            uint64_t data = e.data.load(std::memory_order_relaxed);
+            if ((e.check.load(std::memory_order_relaxed) ^ data) != key || data == 0) continue;
+            lower = static_cast<int8_t>(data);
+            upper = static_cast<int8_t>(data >> 8);
+            bestMove = static_cast<int8_t>(data >> 16);
+            return true;
+        }
+        return false;
+    }
+
+    // Bounds already known for the position are kept, since both are proven, and so is its best
+    // move if 'bestMove' is -1.
+    void store(uint64_t key, int lower, int upper, int bestMove, int empties) {
+        Bucket& bucket = buckets[key & bucketMask];
+        Entry* victim = &bucket.entries[0];
+        int victimEmpties = std::numeric_limits<int>::max();
+        for (Entry& e : bucket.entries) {
+            uint64_t data = e.data.load(std::memory_order_relaxed);
+            if ((e.check.load(std::memory_order_relaxed) ^ data) == key && data != 0) {
+                lower = std::max(lower, static_cast<int>(static_cast<int8_t>(data)));
+                upper = std::min(upper, static_cast<int>(static_cast<int8_t>(data >> 8)));
+                if (bestMove < 0) bestMove = static_cast<int8_t>(data >> 16);
+                victim = &e;
+                break;
+            }
+            int entryEmpties = (data == 0) ? -1 : static_cast<int>((data >> 24) & 0xFF);
+            if (entryEmpties < victimEmpties) {
+                victim = &e;
+                victimEmpties = entryEmpties;
+            }
+        }
+        uint64_t data = static_cast<uint64_t>(static_cast<uint8_t>(lower))
+            | static_cast<uint64_t>(static_cast<uint8_t>(upper)) << 8
+            | static_cast<uint64_t>(static_cast<uint8_t>(bestMove)) << 16
+            | static_cast<uint64_t>(static_cast<uint8_t>(empties)) << 24;
+        victim->data.store(data, std::memory_order_relaxed);
+        victim->check.store(key ^ data, std::memory_order_relaxed);
+    }
+
+private:
+    std::vector<Bucket> owned;
+    Bucket* buckets = nullptr;
+    uint64_t bucketMask = 0;
+};
+
+// Exact endgame search on raw bitboards (player to move, opponent). Scores are the final disc
+// difference for the player to move, with empty squares going to the winner, so a search with
+// the window (-1, 1) only decides win/loss/draw. A smaller NxN board is played in the middle of
+// the 8x8 one: moves are kept inside it, and nothing ever flips across the empty ring around it,
+// so the 8x8 move generator, stability test and parity quadrants apply unchanged. Given a thread
+// pool, the tree is split Young Brothers Wait style, as in the midgame search.
+template<int N>
+class BasicEndgameSolver {
+    static_assert(N <= BOARD_SIZE && (BOARD_SIZE - N) % 2 == 0, "the board must fit centred in 8x8");
+    static const int OFFSET = (BOARD_SIZE - N) / 2;
+    static constexpr uint64_t playableMask() {
+        uint64_t mask = 0;
+        for (int r = OFFSET; r < OFFSET + N; ++r) {
+            for (int c = OFFSET; c < OFFSET + N; ++c) mask |= 1ULL << (r * BOARD_SIZE + c);
+        }
+        return mask;
+    }
+public:
+    static const int SQUARES = N * N;
+    // The squares of the NxN board within the 8x8 one.
+    static constexpr uint64_t MASK = playableMask();
+
+    EndgameTable table;
+    // A solve that runs past the deadline is abandoned; its result is then only meaningful for the
+    // root moves that finished.
+    std::chrono::high_resolution_clock::time_point deadline = std::chrono::high_resolution_clock::time_point::max();
+    // Setting this flag, if given, abandons the solve the same way.
+    const std::atomic<bool>* stopFlag = nullptr;
+    std::atomic<bool> aborted{ false };
+
+    explicit BasicEndgameSolver(size_t hashSizeMb = 4, WorkStealingPool* threadPool = nullptr) :
+        table(hashSizeMb),
+        pool(threadPool),
+        nodeCounters(threadPool ? threadPool->size() : 1) {
+    }
+
+    void clear() {
+        table.clear();
+    }
+
+    // Nodes searched since the last resetNodes(), on all threads. Safe to call during a solve.
+    uint64_t countNodes() const {
+        uint64_t total = 0;
+        for (const auto& counter : nodeCounters) total += counter.nodes.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    void resetNodes() {
+        for (auto& counter : nodeCounters) counter.nodes.store(0, std::memory_order_relaxed);
+    }
+
+    int solve(uint64_t player, uint64_t opponent, int alpha, int beta, int& bestSquare) {
+        bestSquare = -1;
+        aborted.store(false);
+        for (auto& counter : nodeCounters) counter.untilClockCheck = CLOCK_CHECK_INTERVAL;
+        return search(player, opponent, alpha, beta, false, &bestSquare, nullptr);
+    }
+
+    static uint64_t legalMoves(uint64_t player, uint64_t opponent) {
+        return Bitboard::legalMoves(player, opponent) & MASK;
+    }
+
+    static int finalScore(uint64_t player, uint64_t opponent) {
+        int playerDiscs = Bitboard::popCount(player);
+        int opponentDiscs = Bitboard::popCount(opponent);
+        int empties = SQUARES - playerDiscs - opponentDiscs;
+        if (playerDiscs > opponentDiscs) return playerDiscs - opponentDiscs + empties;
+        if (playerDiscs < opponentDiscs) return playerDiscs - opponentDiscs - empties;
+        return 0;
+    }
+
+private:
+    static const int SCORE_BOUND = SQUARES + 1;
+    // At or below this many empties the fixed-size recursion over an empties list takes over.
+    static const int SHALLOW_EMPTIES = 4;
+    // Positions this close to the end are cheaper to re-search than to hash.
+    static const int HASH_MIN_EMPTIES = 7;
+    // Above this many empties, moves are ordered by the opponent's reply count.
+    static const int FASTEST_FIRST_EMPTIES = 5;
+    // Stability cutoffs are tried from here up; nearer the end the search is cheaper than the test.
+    static const int STABILITY_MIN_EMPTIES = 5;
+    // Smaller subtrees are not worth handing to another thread.
+    static const int SPLIT_MIN_EMPTIES = 14;
+    static const int CLOCK_CHECK_INTERVAL = 4096;
+
+    // One per thread and on its own cache line. The count is read by countNodes() while the search
+    // runs, hence atomic; only its own thread writes it.
+    struct alignas(64) NodeCounter {
+        std::atomic<uint64_t> nodes{ 0 };
+        int untilClockCheck = CLOCK_CHECK_INTERVAL;
+    };
+
+    WorkStealingPool* pool;
+    std::vector<NodeCounter> nodeCounters;
+
+    // Quadrants of the board. A move into a quadrant with an odd number of empties tends to get
+    // the last move there, so those are searched first.
+    static constexpr uint64_t QUADRANTS[4] = {
+        0x000000000F0F0F0FULL, 0x00000000F0F0F0F0ULL, 0x0F0F0F0F00000000ULL, 0xF0F0F0F000000000ULL
+    };
+
+    static constexpr std::array<int, BOARD_SIZE * BOARD_SIZE> makeSquareWeights() {
+        std::array<int, BOARD_SIZE * BOARD_SIZE> weights{};
+        for (int r = 0; r < N; ++r) {
+            for (int c = 0; c < N; ++c) weights[(r + OFFSET) * BOARD_SIZE + c + OFFSET] = BoardGeometry<N>::SQUARE_WEIGHTS[r * N + c];
+        }
+        return weights;
+    }
+    static constexpr std::array<int, BOARD_SIZE * BOARD_SIZE> SQUARE_WEIGHTS = makeSquareWeights();
+
+    static uint64_t oddQuadrants(uint64_t empties) {
+        uint64_t odd = 0;
+        for (uint64_t quadrant : QUADRANTS) {
+            if (Bitboard::popCount(empties & quadrant) & 1) odd |= quadrant;
+        }
+        return odd;
+    }
+
+    static void countNode(NodeCounter& counter) {
+        counter.nodes.store(counter.nodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    bool isCancelled(const SplitPoint* split) const {
+        return aborted.load(std::memory_order_relaxed) || (split && split->cancelled());
+    }
+
+    int solveLastEmpty(NodeCounter& counter, uint64_t player, uint64_t opponent, int square) {
+        countNode(counter);
+        int playerDiscs = Bitboard::popCount(player);
+        uint64_t flipped = Bitboard::flips(square, player, opponent);
+        if (flipped) return 2 * (playerDiscs + 1 + Bitboard::popCount(flipped)) - SQUARES;
+        flipped = Bitboard::flips(square, opponent, player);
+        if (flipped) return 2 * (playerDiscs - Bitboard::popCount(flipped)) - SQUARES;
+        int score = 2 * playerDiscs - (SQUARES - 1);
+        return score > 0 ? score + 1 : score - 1;
+    }
+
+    // Last few empties: no move generation, hashing or sorting, just the empties list in parity order.
+    int solveShallow(NodeCounter& counter, uint64_t player, uint64_t opponent, int alpha, int beta, const int* empties, int count, bool passed) {
+        if (count == 1) return solveLastEmpty(counter, player, opponent, empties[0]);
+        countNode(counter);
+        int bestScore = -SCORE_BOUND;
+        int rest[SHALLOW_EMPTIES];
+        for (int i = 0; i < count; ++i) {
+            uint64_t flipped = Bitboard::flips(empties[i], player, opponent);
+            if (!flipped) continue;
+            for (int j = 0, k = 0; j < count; ++j) {
+                if (j != i) rest[k++] = empties[j];
+            }
+            int score = -solveShallow(counter, opponent ^ flipped, player | flipped | (1ULL << empties[i]), -beta, -alpha, rest, count - 1, false);
+            if (score > bestScore) {
+                bestScore = score;
+                if (score > alpha) alpha = score;
+                if (alpha >= beta) break;
+            }
+        }
+        if (bestScore == -SCORE_BOUND) {
+            if (passed) return finalScore(player, opponent);
+            return -solveShallow(counter, opponent, player, -beta, -alpha, empties, count, true);
+        }
+        return bestScore;
+    }
+
+    // A search below a cancelled split point, or in an abandoned solve, returns early; its result
+    // is discarded and never stored.
+    int search(uint64_t player, uint64_t opponent, int alpha, int beta, bool passed, int* bestSquareOut, const SplitPoint* split) {
+        NodeCounter& counter = nodeCounters[pool ? pool->currentSlot() : 0];
+        uint64_t empties = MASK & ~(player | opponent);
+        int emptyCount = Bitboard::popCount(empties);
+        if (emptyCount <= SHALLOW_EMPTIES && !bestSquareOut) {
+            if (emptyCount == 0) return finalScore(player, opponent);
+            int list[SHALLOW_EMPTIES];
+            int count = 0;
+            uint64_t odd = oddQuadrants(empties);
+            for (uint64_t b = empties & odd; b; b &= b - 1) list[count++] = Bitboard::firstSquare(b);
+            for (uint64_t b = empties & ~odd; b; b &= b - 1) list[count++] = Bitboard::firstSquare(b);
+            return solveShallow(counter, player, opponent, alpha, beta, list, count, passed);
+        }
+
+        countNode(counter);
+        if (--counter.untilClockCheck <= 0) {
+            counter.untilClockCheck = CLOCK_CHECK_INTERVAL;
+            if (std::chrono::high_resolution_clock::now() >= deadline || (stopFlag && stopFlag->load())) aborted.store(true);
+        }
+        if (isCancelled(split)) return 0;
+        uint64_t moveMask = legalMoves(player, opponent);
+        if (moveMask == 0) {
+            if (passed) return finalScore(player, opponent);
+            return -search(opponent, player, -beta, -alpha, true, nullptr, split);
+        }
+
+        // The opponent keeps at least its stable discs, which caps the final score. That can only
+        // fail low if the opponent has enough discs for the cap to reach alpha at all. Outside a
+        // smaller board, the empty ring counts as the opponent's: nothing crosses it, so to the
+        // stability test it is the board edge.
+        if (!bestSquareOut && emptyCount >= STABILITY_MIN_EMPTIES && SQUARES - 2 * Bitboard::popCount(opponent) <= alpha) {
+            int upper = SQUARES - 2 * Bitboard::popCount(Bitboard::stableDiscs(opponent | ~MASK, player) & MASK);
+            if (upper <= alpha) return upper;
+        }
+
+        uint64_t key = 0;
+        int hashMove = -1;
+        if (emptyCount >= HASH_MIN_EMPTIES) {
+            key = EndgameTable::keyOf(player, opponent);
+            int lower, upper;
+            if (table.probe(key, lower, upper, hashMove) && !bestSquareOut) {
+                if (lower >= beta) return lower;
+                if (upper <= alpha) return upper;
+                if (lower == upper) return lower;
+                alpha = std::max(alpha, lower);
+                beta = std::min(beta, upper);
+            }
+        }
+
+        int searchedAlpha = alpha, searchedBeta = beta;
+        int squares[BOARD_SIZE * BOARD_SIZE];
+        uint64_t flippedBy[BOARD_SIZE * BOARD_SIZE];
+        int keys[BOARD_SIZE * BOARD_SIZE];
+        int moveCount = 0;
+        uint64_t odd = oddQuadrants(empties);
+        for (; moveMask; moveMask &= moveMask - 1) {
+            int sq = Bitboard::firstSquare(moveMask);
+            uint64_t flipped = Bitboard::flips(sq, player, opponent);
+            int key = SQUARE_WEIGHTS[sq];
+            if ((odd >> sq) & 1) key += 256;
+            if (sq == hashMove) {
+                key = SCORE_INFINITY;
+            }
+            else if (emptyCount > FASTEST_FIRST_EMPTIES) {
+                uint64_t replies = legalMoves(opponent ^ flipped, player | flipped | (1ULL << sq));
+                key -= 1024 * Bitboard::popCount(replies);
+            }
+            int i = moveCount++;
+            while (i > 0 && keys[i - 1] < key) {
+                keys[i] = keys[i - 1];
+                squares[i] = squares[i - 1];
+                flippedBy[i] = flippedBy[i - 1];
+                --i;
+            }
+            keys[i] = key;
+            squares[i] = sq;
+            flippedBy[i] = flipped;
+        }
+
+        // Principal variation search: the first move gets the full window, the others a null
+        // window that is only widened when a move turns out better.
+        int bestScore = -SCORE_BOUND;
+        int bestSquare = -1;
+        for (int i = 0; i < moveCount; ++i) {
+            if (i == 1 && pool && emptyCount >= SPLIT_MIN_EMPTIES) {
+                bestScore = searchInParallel(player, opponent, squares + 1, flippedBy + 1, moveCount - 1, alpha, beta, split, bestScore, bestSquare);
+                break;
+            }
+            uint64_t childPlayer = opponent ^ flippedBy[i];
+            uint64_t childOpponent = player | flippedBy[i] | (1ULL << squares[i]);
+            int score;
+            if (i == 0) {
+                score = -search(childPlayer, childOpponent, -beta, -alpha, false, nullptr, split);
+            }
+            else {
+                score = -search(childPlayer, childOpponent, -alpha - 1, -alpha, false, nullptr, split);
+                if (score > alpha && score < beta) {
+                    score = -search(childPlayer, childOpponent, -beta, -score, false, nullptr, split);
+                }
+            }
+            if (isCancelled(split)) break;
+            if (score > bestScore) {
+                bestScore = score;
+                bestSquare = squares[i];
+                if (score > alpha) alpha = score;
+                if (alpha >= beta) break;
+            }
+        }
+
+        if (bestSquareOut) *bestSquareOut = bestSquare;
+        if (isCancelled(split)) return bestScore;
+        if (emptyCount >= HASH_MIN_EMPTIES) {
+            int lower = (bestScore > searchedAlpha) ? bestScore : -SQUARES;
+            int upper = (bestScore < searchedBeta) ? bestScore : SQUARES;
+            table.store(key, lower, upper, bestSquare, emptyCount);
+        }
+        return bestScore;
+    }
+
+    // The younger brothers go to the pool. Each gets a null window at alpha as it stands when it
+    // starts, and a full re-search if it beats that, as in the sequential loop.
+    int searchInParallel(uint64_t player, uint64_t opponent, const int* squares, const uint64_t* flippedBy, int moveCount,
+        int alpha, int beta, const SplitPoint* split, int bestScore, int& bestSquare) {
+        SplitPoint sp(split, alpha, beta, bestScore, bestSquare);
+        if (alpha >= beta) return bestScore;
+        sp.pending.store(moveCount);
+        for (int i = 0; i < moveCount; ++i) {
+            uint64_t childPlayer = opponent ^ flippedBy[i];
+            uint64_t childOpponent = player | flippedBy[i] | (1ULL << squares[i]);
+            pool->submit([this, &sp, childPlayer, childOpponent, square = squares[i]] {
+                if (!isCancelled(&sp)) {
+                    int windowAlpha;
+                    {
+                        std::lock_guard<std::mutex> lock(sp.mutex);
+                        windowAlpha = sp.alpha;
+                    }
+                    int score = -search(childPlayer, childOpponent, -windowAlpha - 1, -windowAlpha, false, nullptr, &sp);
+                    if (score > windowAlpha && score < sp.beta && !isCancelled(&sp)) {
+                        score = -search(childPlayer, childOpponent, -sp.beta, -score, false, nullptr, &sp);
+                    }
+                    if (!isCancelled(&sp)) {
+                        std::lock_guard<std::mutex> lock(sp.mutex);
+                        if (score > sp.bestScore) {
+                            sp.bestScore = score;
+                            sp.bestSquare = square;
+                        }
+                        sp.alpha = std::max(sp.alpha, score);
+                        if (sp.alpha >= sp.beta) sp.cutoff.store(true);
+                    }
+                }
+                sp.pending.fetch_sub(1);
+            });
+        }
+        while (sp.pending.load() > 0) {
+            if (!pool->runPendingTask()) std::this_thread::yield();
+        }
+        bestSquare = sp.bestSquare;
+        return sp.bestScore;
+    }
+};
+using EndgameSolver = BasicEndgameSolver<BOARD_SIZE>;
+
+// Multi-ProbCut. A deep search result is predicted from a shallow one as deep = a * shallow + b,
+// with a normally distributed error of 'sigma'. When the shallow result says the deep one is
+// outside the window with enough confidence, the node is cut without searching it deeply. The
+// parameters depend on the game stage and the depth, and are fitted offline from self-play
+// positions (--fit-probcut); without a parameter file conservative defaults are used.
+namespace ProbCut {
+    const char PARAMS_MAGIC[8] = { 'O', 'T', 'H', 'P', 'C', 'U', 'T', '1' };
+    const int MIN_DEPTH = 3;
+    // Deeper searches use the parameters of the deepest fitted depth with the same parity.
+    const int MAX_DEPTH = 10;
+    // How many standard deviations the prediction must clear; 0 turns pruning off.
+    const double DEFAULT_CONFIDENCE = 1.5;
+    // Scores past this are decided games, which the linear model does not describe.
+    const int MAX_MODEL_SCORE = 15000;
+    // Default error per stage for the built-in weights, from the top end of a fit to them. Trained
+    // weights score on another scale and need their own fit.
+    const float DEFAULT_SIGMA[Patterns::STAGE_COUNT] = { 300, 300, 200, 450, 950, 1650, 2100, 2100 };
+
+    struct Params {
+        float a = 1.0f, b = 0.0f, sigma = 0.0f;
+    };
+    using Table = std::array<std::array<Params, MAX_DEPTH + 1>, Patterns::STAGE_COUNT>;
+
+    // About half the depth, keeping the parity: Othello scores swing with the side to move, so an
+    // odd-depth search is a poor predictor of an even-depth one.
+    inline int shallowDepth(int depth) {
+        int half = depth / 2;
+        return half - ((half ^ depth) & 1);
+    }
+
+    inline int tableDepth(int depth) {
+        return (depth <= MAX_DEPTH) ? depth : MAX_DEPTH - ((MAX_DEPTH ^ depth) & 1);
+    }
+
+    inline Table makeDefaultParams() {
+        Table table;
+        for (int stage = 0; stage < Patterns::STAGE_COUNT; ++stage) {
+            for (int depth = MIN_DEPTH; depth <= MAX_DEPTH; ++depth) {
+                table[stage][depth].sigma = DEFAULT_SIGMA[stage];
+            }
+        }
+        return table;
+    }
+
+    inline Table& params() {
+        static Table table = makeDefaultParams();
+        return table;
+    }
+
+    inline const Params& params(int stage, int depth) {
+        return params()[stage][tableDepth(depth)];
+    }
+
+    inline bool saveParams(const Table& table, const std::string& path) {
+        std::ofstream file(path, std::ios::binary);
+        if (!file) return false;
+        uint32_t shape[2] = { static_cast<uint32_t>(Patterns::STAGE_COUNT), static_cast<uint32_t>(MAX_DEPTH) };
+        file.write(PARAMS_MAGIC, sizeof(PARAMS_MAGIC));
+        file.write(reinterpret_cast<const char*>(shape), sizeof(shape));
+        file.write(reinterpret_cast<const char*>(&table), sizeof(table));
+        return static_cast<bool>(file);
+    }
+
+    inline bool loadParams(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return false;
+        char magic[sizeof(PARAMS_MAGIC)];
+        uint32_t shape[2];
+        if (!file.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), PARAMS_MAGIC)) return false;
+        if (!file.read(reinterpret_cast<char*>(shape), sizeof(shape)) ||
+            shape[0] != static_cast<uint32_t>(Patterns::STAGE_COUNT) || shape[1] != static_cast<uint32_t>(MAX_DEPTH)) return false;
+        Table loaded;
+        if (!file.read(reinterpret_cast<char*>(&loaded), sizeof(loaded))) return false;
+        params() = loaded;
+        return true;
+    }
+}
+
+template<int N>
+class BasicAIPlayer {
+public:
+    using BoardType = BasicBoard<N>;
+    using Bits = typename BoardType::Bits;
+
     int maxDepth;
     std::chrono::milliseconds timeLimitPerMove;
     std::mt19937 rng;
-
-    AIPlayer(int depth = 4, int timeLimitMs = 1500) :
+    uint64_t nodesSearched = 0;
+    double effectiveBranchingFactor = 0.0;
+    int completedDepth = 0;
+    // Score of the chosen move in the last completed iteration, for the side to move; the disc
+    // difference when the move was solved, and 0 when nothing was searched.
+    int lastScore = 0;
+    // A forced move is normally played without a search. Callers that record lastScore (book
+    // building, ProbCut fitting) set this to have it searched like any other position.
+    bool searchForcedMoves = false;
+    TranspositionTable transpositionTable;
+    EndgameSolver endgameSolver;
+    // With this few empty squares the move is picked by perfect play instead of the heuristic:
+    // an exact disc-difference solve, or just win/loss/draw a few empties earlier.
+    int exactSolveEmpties = 18;
+    int wldSolveEmpties = 20;
+    bool lastMoveSolved = false;
+    bool lastSolveExact = false;
+    int lastSolveScore = 0;
+    // Nodes searched by the last ponder, i.e. while the opponent was thinking.
+    uint64_t ponderNodes = 0;
+    // Multi-ProbCut confidence in standard deviations; 0 searches full width.
+    double probCutConfidence = ProbCut::DEFAULT_CONFIDENCE;
+
+    BasicAIPlayer(int depth = 4, int timeLimitMs = 1500, int threadCount = 1, size_t hashSizeMb = 16) :
         maxDepth(depth),
         timeLimitPerMove(std::chrono::milliseconds(static_cast<long long>(timeLimitMs))),
-        rng(std::random_device{}()) {
+        rng(std::random_device{}()),
+        transpositionTable(hashSizeMb),
+        nodeCounters(std::max(1, threadCount)) {
+        if (threadCount > 1) {
+            pool.reset(new WorkStealingPool(threadCount));
+        }
+        endgameSolver.stopFlag = &stopSearch;
+    }
+    ~BasicAIPlayer() {
+        stopPondering();
+    }
+
+    int threadCount() const { return pool ? pool->size() : 1; }
+
+    Move findBestMoveIterativeDeepening(const BoardType& board, PlayerColor player) {
+        stopPondering();
+        stopSearch.store(false);
+        auto startTime = std::chrono::high_resolution_clock::now();
+        return think(board, player, 0, startTime + timeLimitPerMove);
     }
 
-    Move findBestMoveIterativeDeepening(const Board& board, PlayerColor player) {
+    // Searches the opponent's position in the background until stopPondering(). That fills the
+    // hash tables with the positions after their likely replies, one ply deeper (and one empty
+    // square earlier for the solver) than our own search would go, so most of our next search is
+    // already done when it starts.
+    void startPondering(const BoardType& board, PlayerColor opponent) {
+        stopPondering();
+        stopSearch.store(false);
+        ponderThread = std::thread([this, board, opponent]() {
+            think(board, opponent, 1, std::chrono::high_resolution_clock::time_point::max());
+        });
+    }
+
+    void stopPondering() {
+        if (!ponderThread.joinable()) return;
+        stopSearch.store(true);
+        ponderThread.join();
+        ponderNodes = nodesSearched;
+    }
+
+private:
+    // Iterative deepening up to maxDepth + extraPlies, or an endgame solve with that many more
+    // empty squares than usual, stopping at 'searchDeadline' or when stopSearch is set.
+    Move think(const BoardType& board, PlayerColor player, int extraPlies, std::chrono::high_resolution_clock::time_point searchDeadline) {
         Move bestMoveOverall = { -1, -1 };
         auto startTime = std::chrono::high_resolution_clock::now();
+        deadline = searchDeadline;
+        for (auto& counter : nodeCounters) counter.nodes = 0;
+        nodesSearched = 0;
+        effectiveBranchingFactor = 0.0;
+        completedDepth = 0;
+        lastScore = 0;
+        transpositionTable.newSearch();
+
+        lastMoveSolved = false;
 
         std::vector<Move> validMoves = board.getValidMoves(player);
         if (validMoves.empty()) return { -1, -1 };
-        if (validMoves.size() == 1) return validMoves[0];
+        if (validMoves.size() == 1 && !searchForcedMoves) return validMoves[0];
+
+        // The endgame solver works on 8x8 bitboards; on other sizes the search reaches the end of
+        // the game by itself once its depth covers the empty squares.
+        if constexpr (N == BOARD_SIZE) {
+            int empties = Bitboard::popCount(board.emptySquares());
+            if (empties <= wldSolveEmpties + extraPlies) {
+                // The solver gets most of the budget; if it cannot finish, the rest goes to the heuristic search.
+                auto solveDeadline = (deadline == std::chrono::high_resolution_clock::time_point::max())
+                    ? deadline : startTime + (deadline - startTime) * 3 / 4;
+                Move solved = solveEndgame(board, player, empties <= exactSolveEmpties + extraPlies, solveDeadline);
+                if (lastMoveSolved) { lastScore = lastSolveScore; return solved; }
+                if (stopSearch.load()) return { -1, -1 };
+            }
+        }
 
         std::shuffle(validMoves.begin(), validMoves.end(), rng);
         bestMoveOverall = validMoves[0];
+        BoardType searchBoard = board;
+        std::vector<int> rootSquares;
+        for (const auto& move : validMoves) {
+            rootSquares.push_back(move.row * N + move.col);
+        }
 
-        for (int currentDepth = 1; currentDepth <= maxDepth; ++currentDepth) {
-            Move bestMoveThisIteration = { -1, -1 };
-            int bestScoreThisIteration = std::numeric_limits<int>::min();
-            originalAIPlayer = player;
-
-            for (const auto& move : validMoves) {
-                Board nextBoard = board;
-                std::vector<Move> flips = nextBoard.getFlipsForMove(move.row, move.col, player); // Get flips before applying
-                nextBoard.applyMove(move, player, flips); // Pass flips to applyMove
-                int score = minimax(nextBoard, currentDepth - 1, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), false, player, getOpponent(player));
-
-                if (score > bestScoreThisIteration) {
-                    bestScoreThisIteration = score;
-                    bestMoveThisIteration = move;
+        uint64_t previousIterationNodes = 0;
+        for (int currentDepth = 1; currentDepth <= maxDepth + extraPlies; ++currentDepth) {
+            auto iterationStart = std::chrono::high_resolution_clock::now();
+            uint64_t nodesBeforeIteration = countNodes();
+            int alpha = -SCORE_INFINITY;
+            int bestSquare = -1;
+            int bestScore = searchMoves(searchBoard, rootSquares.data(), static_cast<int>(rootSquares.size()), currentDepth,
+                alpha, SCORE_INFINITY, player, true, nullptr, bestSquare);
+            bool aborted = stopSearch.load();
+
+            // An aborted iteration still counts for the root moves it finished: the previous best
+            // move is searched first, so anything that beat it did so at the deeper depth.
+            if (bestSquare >= 0) {
+                bestMoveOverall = { bestSquare / N, bestSquare % N };
+                // The next, deeper iteration starts from this iteration's best move.
+                auto bestPosition = std::find(rootSquares.begin(), rootSquares.end(), bestSquare);
+                std::rotate(rootSquares.begin(), bestPosition, bestPosition + 1);
+                if (!aborted) {
+                    transpositionTable.store(searchBoard.hashFor(player), currentDepth, bestScore, TranspositionTable::EXACT, bestSquare);
                 }
             }
+            if (aborted) break;
+            completedDepth = currentDepth;
+            lastScore = bestScore;
 
-            if (bestMoveThisIteration.isValid()) {
-                bestMoveOverall = bestMoveThisIteration;
+            uint64_t iterationNodes = countNodes() - nodesBeforeIteration;
+            if (previousIterationNodes > 0) {
+                effectiveBranchingFactor = static_cast<double>(iterationNodes) / previousIterationNodes;
             }
+            previousIterationNodes = iterationNodes;
 
+            // Don't start an iteration that would run past the deadline anyway.
             auto currentTime = std::chrono::high_resolution_clock::now();
-            if (std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - startTime) >= timeLimitPerMove && currentDepth < maxDepth) {
+            double branchingFactor = (effectiveBranchingFactor > 0.0) ? effectiveBranchingFactor : DEFAULT_BRANCHING_FACTOR;
+            auto predictedNextIteration = std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+                (currentTime - iterationStart) * branchingFactor);
+            if (currentTime + predictedNextIteration > deadline) {
                 break;
             }
         }
+        nodesSearched = countNodes();
         return bestMoveOverall;
     }
 
-private:
-    PlayerColor originalAIPlayer;
+    Move solveEndgame(const BoardType& board, PlayerColor player, bool exact, std::chrono::high_resolution_clock::time_point solveDeadline) {
+        endgameSolver.resetNodes();
+        endgameSolver.deadline = solveDeadline;
+        int bestSquare = -1;
+        int window = exact ? SCORE_INFINITY : 1;
+        int score = endgameSolver.solve(board.discsOf(player), board.discsOf(getOpponent(player)), -window, window, bestSquare);
+        nodesSearched = endgameSolver.countNodes();
+        // An unfinished solve is still good enough once one of the moves it finished is a proven win.
+        if (endgameSolver.aborted && (bestSquare < 0 || score <= 0)) {
+            return { -1, -1 };
+        }
+        lastSolveScore = score;
+        lastSolveExact = exact && !endgameSolver.aborted;
+        lastMoveSolved = true;
+        return { bestSquare / BOARD_SIZE, bestSquare % BOARD_SIZE };
+    }
+
+    // Below this depth a child's reply count costs about as much as searching it, so only the
+    // piece-square prior is used.
+    static const int FASTEST_FIRST_MIN_DEPTH = 2;
+    // Subtrees shallower than this are not worth handing to another thread.
+    static const int MIN_SPLIT_DEPTH = 4;
+    // Each thread looks at the clock once per this many nodes.
+    static const int CLOCK_CHECK_INTERVAL = 1024;
+    // Used to predict the second iteration, before any branching factor has been measured.
+    static constexpr double DEFAULT_BRANCHING_FACTOR = 4.0;
+
+    // One per thread and on its own cache line, so counting nodes never contends.
+    struct alignas(64) NodeCounter {
+        uint64_t nodes = 0;
+    };
+
+    std::unique_ptr<WorkStealingPool> pool;
+    std::thread ponderThread;
+    std::vector<NodeCounter> nodeCounters;
+    std::chrono::high_resolution_clock::time_point deadline;
+    std::atomic<bool> stopSearch{ false };
+
+    uint64_t countNodes() const {
+        uint64_t total = 0;
+        for (const auto& counter : nodeCounters) total += counter.nodes;
+        return total;
+    }
+
+    bool isCancelled(const SplitPoint* split) const {
+        return stopSearch.load(std::memory_order_relaxed) || (split && split->cancelled());
+    }
+
+    // Fills 'squares' with the legal moves in search order: hash move, then fewest opponent
+    // replies, then the piece-square table. Deterministic, so alpha-beta sees the same tree every time.
+    int orderMoves(BoardType& board, Bits moveMask, PlayerColor sideToMove, int hashMove, int depth, int* squares) const {
+        using G = typename BoardType::G;
+        int keys[N * N];
+        int moveCount = 0;
+        PlayerColor opponent = getOpponent(sideToMove);
+        for (; moveMask; moveMask = Bitboard::withoutFirst(moveMask)) {
+            int sq = Bitboard::firstSquare(moveMask);
+            int key = G::SQUARE_WEIGHTS[sq];
+            if (sq == hashMove) {
+                key = SCORE_INFINITY;
+            }
+            else if (depth >= FASTEST_FIRST_MIN_DEPTH) {
+                Bits player = board.discsOf(sideToMove), other = board.discsOf(opponent);
+                Bits flipped = G::flips(sq, player, other);
+                key -= 1024 * Bitboard::popCount(G::legalMoves(other ^ flipped, player | flipped | G::bit(sq)));
+            }
+            // Insertion sort, highest key first; move lists are short.
+            int i = moveCount++;
+            while (i > 0 && keys[i - 1] < key) {
+                keys[i] = keys[i - 1];
+                squares[i] = squares[i - 1];
+                --i;
+            }
+            keys[i] = key;
+            squares[i] = sq;
+        }
+        return moveCount;
+    }
+
+    // Searches the given moves in order and returns the best score, raising 'alpha' as it goes.
+    // Young Brothers Wait: at PV nodes deep enough to be worth it, the eldest brother is searched
+    // first on this thread and the remaining ones are then handed to the pool.
+    int searchMoves(BoardType& board, const int* squares, int moveCount, int depth, int& alpha, int beta,
+        PlayerColor sideToMove, bool pvNode, const SplitPoint* split, int& bestSquare) {
+        PlayerColor opponent = getOpponent(sideToMove);
+        int bestScore = -SCORE_INFINITY;
+        for (int i = 0; i < moveCount; ++i) {
+            if (i == 1 && pool && pvNode && depth >= MIN_SPLIT_DEPTH) {
+                return searchInParallel(board, squares + 1, moveCount - 1, depth, alpha, beta, sideToMove, split, bestScore, bestSquare);
+            }
+            Bits flipped = board.makeMove(squares[i], sideToMove);
+            int score = -negamax(board, depth - 1, -beta, -alpha, opponent, pvNode && i == 0, split);
+            board.undoMove(squares[i], sideToMove, flipped);
+            if (isCancelled(split)) return bestScore;
+            if (score > bestScore) {
+                bestScore = score;
+                bestSquare = squares[i];
+            }
+            alpha = std::max(alpha, score);
+            if (alpha >= beta) break;
+        }
+        return bestScore;
+    }
+
+    int searchInParallel(const BoardType& board, const int* squares, int moveCount, int depth, int& alpha, int beta,
+        PlayerColor sideToMove, const SplitPoint* split, int bestScore, int& bestSquare) {
+        SplitPoint sp(split, alpha, beta, bestScore, bestSquare);
+        if (alpha >= beta) return bestScore;
+        sp.pending.store(moveCount);
+        for (int i = 0; i < moveCount; ++i) {
+            pool->submit([this, &sp, board, square = squares[i], depth, sideToMove] {
+                if (!isCancelled(&sp)) {
+                    BoardType child = board;
+                    child.makeMove(square, sideToMove);
+                    int windowAlpha;
+                    {
+                        std::lock_guard<std::mutex> lock(sp.mutex);
+                        windowAlpha = sp.alpha;
+                    }
+                    int score = -negamax(child, depth - 1, -sp.beta, -windowAlpha, getOpponent(sideToMove), false, &sp);
+                    if (!isCancelled(&sp)) {
+                        std::lock_guard<std::mutex> lock(sp.mutex);
+                        if (score > sp.bestScore) {
+                            sp.bestScore = score;
+                            sp.bestSquare = square;
+                        }
+                        sp.alpha = std::max(sp.alpha, score);
+                        if (sp.alpha >= sp.beta) sp.cutoff.store(true);
+                    }
+                }
+                sp.pending.fetch_sub(1);
+            });
+        }
+        while (sp.pending.load() > 0) {
+            if (!pool->runPendingTask()) std::this_thread::yield();
+        }
+        alpha = sp.alpha;
+        bestSquare = sp.bestSquare;
+        return sp.bestScore;
+    }
 
-    int minimax(Board& board, int depth, int alpha, int beta, bool maximizingPlayer, PlayerColor aiPlayerPerspective, PlayerColor currentPlayerTurn) {
-        if (depth == 0 || board.isGameOver()) {
-            return board.evaluate(aiPlayerPerspective);
+    // Returns true, with the bound to return in 'score', when a null-window search at the shallow
+    // depth predicts that the full-depth result fails high (or low) with the configured confidence.
+    bool probCut(BoardType& board, int depth, int alpha, int beta, PlayerColor sideToMove, const SplitPoint* split, int& score) {
+        const ProbCut::Params& p = ProbCut::params(Patterns::stageOf(Bitboard::popCount(board.blackDiscs | board.whiteDiscs)), depth);
+        int shallow = ProbCut::shallowDepth(depth);
+        double margin = probCutConfidence * p.sigma;
+        if (beta < ProbCut::MAX_MODEL_SCORE) {
+            int bound = static_cast<int>(std::ceil((beta + margin - p.b) / p.a));
+            if (bound < ProbCut::MAX_MODEL_SCORE && negamax(board, shallow, bound - 1, bound, sideToMove, false, split) >= bound) {
+                score = beta;
+                return true;
+            }
+        }
+        if (alpha > -ProbCut::MAX_MODEL_SCORE) {
+            int bound = static_cast<int>(std::floor((alpha - margin - p.b) / p.a));
+            if (bound > -ProbCut::MAX_MODEL_SCORE && negamax(board, shallow, bound, bound + 1, sideToMove, false, split) <= bound) {
+                score = alpha;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Negamax alpha-beta on a single board with make/undo. Scores are relative to the side to move,
+    // which lets transposition entries be reused no matter which colour the AI plays. A search under
+    // a cancelled split point, or after the deadline, returns early and its result is discarded.
+    int negamax(BoardType& board, int depth, int alpha, int beta, PlayerColor sideToMove, bool pvNode, const SplitPoint* split) {
+        uint64_t nodes = ++nodeCounters[pool ? pool->currentSlot() : 0].nodes;
+        if (nodes % CLOCK_CHECK_INTERVAL == 0 && std::chrono::high_resolution_clock::now() >= deadline) {
+            stopSearch.store(true);
+        }
+        if (isCancelled(split)) return 0;
+        PlayerColor opponent = getOpponent(sideToMove);
+        Bits moveMask = board.getValidMoveMask(sideToMove);
+
+        if (depth == 0 || (!moveMask && !board.getValidMoveMask(opponent))) {
+            return board.evaluate(sideToMove);
+        }
+        if (!moveMask) {
+            return -negamax(board, depth - 1, -beta, -alpha, opponent, pvNode, split);
+        }
+
+        int originalAlpha = alpha;
+        uint64_t key = board.hashFor(sideToMove);
+        int hashMove = -1;
+        TranspositionTable::Entry entry;
+        if (transpositionTable.probe(key, entry)) {
+            hashMove = entry.bestMove;
+            if (entry.depth >= depth) {
+                if (entry.bound == TranspositionTable::EXACT) return entry.score;
+                if (entry.bound == TranspositionTable::LOWER_BOUND) alpha = std::max(alpha, static_cast<int>(entry.score));
+                else beta = std::min(beta, static_cast<int>(entry.score));
+                if (alpha >= beta) return entry.score;
+            }
+        }
+
+        // The first move of a PV node is always searched in full, so the principal line stays exact.
+        // The cut parameters are fitted to the 8x8 pattern evaluation.
+        if constexpr (N == BOARD_SIZE) {
+            if (!pvNode && depth >= ProbCut::MIN_DEPTH && probCutConfidence > 0.0) {
+                int cutScore;
+                if (probCut(board, depth, alpha, beta, sideToMove, split, cutScore)) return cutScore;
+            }
+        }
+
+        int squares[N * N];
+        int moveCount = orderMoves(board, moveMask, sideToMove, hashMove, depth, squares);
+
+        int bestSquare = -1;
+        int bestScore = searchMoves(board, squares, moveCount, depth, alpha, beta, sideToMove, pvNode, split, bestSquare);
+        if (isCancelled(split)) return bestScore;
+
+        TranspositionTable::Bound bound = (bestScore <= originalAlpha) ? TranspositionTable::UPPER_BOUND
+            : (bestScore >= beta) ? TranspositionTable::LOWER_BOUND : TranspositionTable::EXACT;
+        transpositionTable.store(key, depth, bestScore, bound, bestSquare);
+        return bestScore;
+    }
+};
+using AIPlayer = BasicAIPlayer<BOARD_SIZE>;
+
+// Counts the leaf positions 'depth' plies ahead on the NxN board, a pass counting as a ply, to
+// check the move generator against known totals and to time it.
+template<int N>
+uint64_t perft(typename BoardGeometry<N>::Bits player, typename BoardGeometry<N>::Bits opponent, int depth, bool passed = false) {
+    using G = BoardGeometry<N>;
+    if (depth == 0) return 1;
+    typename G::Bits moveMask = G::legalMoves(player, opponent);
+    if (!moveMask) {
+        return passed ? 1 : perft<N>(opponent, player, depth - 1, true);
+    }
+    uint64_t total = 0;
+    for (auto b = moveMask; b; b = Bitboard::withoutFirst(b)) {
+        int sq = Bitboard::firstSquare(b);
+        typename G::Bits flipped = G::flips(sq, player, opponent);
+        total += perft<N>(opponent ^ flipped, player | flipped | G::bit(sq), depth - 1);
+    }
+    return total;
+}
+
+// Solvers for the board sizes small enough to solve from the start position.
+namespace Variant {
+    // Solves the start position with the endgame solver, on all threads. Its table lives in a
+    // memory-mapped file, so the table can be larger than memory (the OS pages it out) and outlives
+    // the process. The start position is narrowed down by null-window tests whose results are kept
+    // in the file header; a rerun resumes from those bounds, with every position the interrupted
+    // run had proven still in the table.
+    template<int N>
+    class WeakSolver {
+    public:
+        using Solver = BasicEndgameSolver<N>;
+        static const int SQUARES = N * N;
+        static constexpr char MAGIC[8] = { 'O', 'T', 'H', 'S', 'O', 'L', 'V', '1' };
+
+        // The first 64 bytes of the file.
+        struct Header {
+            char magic[8];
+            uint32_t boardSize;
+            uint32_t reserved;
+            uint64_t bucketCount;
+            // Proven bounds on the start position's score for Black.
+            int32_t lower, upper;
+            // Totals over every run on this file.
+            uint64_t nodes;
+            double seconds;
+            char padding[16];
+        };
+        static_assert(sizeof(Header) == 64, "header is one cache line");
+
+        // The solver starts with a token table of its own; open() points it at the file.
+        explicit WeakSolver(int threadCount) :
+            pool(threadCount > 1 ? new WorkStealingPool(threadCount) : nullptr),
+            solver(0, pool.get()) {
+        }
+        WeakSolver(const WeakSolver&) = delete;
+        WeakSolver& operator=(const WeakSolver&) = delete;
+        ~WeakSolver() { close(); }
+
+        // Maps 'path', creating a table of about 'sizeMb' if the file is missing or was not written
+        // for this board size. Sets 'resumed' when an earlier run's table is picked up.
+        bool open(const std::string& path, size_t sizeMb, bool& resumed) {
+            close();
+            uint64_t bucketCount = EndgameTable::bucketCountFor(sizeMb);
+            uint64_t fileSize = sizeof(Header) + bucketCount * sizeof(Bucket);
+            Header existing = {};
+            resumed = false;
+            {
+                std::ifstream file(path, std::ios::binary);
+                if (file.read(reinterpret_cast<char*>(&existing), sizeof(existing)) &&
+                    std::equal(MAGIC, MAGIC + sizeof(MAGIC), existing.magic) && existing.boardSize == static_cast<uint32_t>(N) &&
+                    existing.bucketCount != 0 && (existing.bucketCount & (existing.bucketCount - 1)) == 0) {
+                    file.seekg(0, std::ios::end);
+                    if (static_cast<uint64_t>(file.tellg()) == sizeof(Header) + existing.bucketCount * sizeof(Bucket)) {
+                        resumed = true;
+                        bucketCount = existing.bucketCount;
+                        fileSize = sizeof(Header) + bucketCount * sizeof(Bucket);
+                    }
+                }
+            }
+            if (!mapFile(path, fileSize, !resumed)) {
+                close();
+                return false;
+            }
+            header = static_cast<Header*>(view);
+            solver.table.attach(reinterpret_cast<Bucket*>(static_cast<char*>(view) + sizeof(Header)), bucketCount);
+            if (!resumed) {
+                std::memcpy(header->magic, MAGIC, sizeof(MAGIC));
+                header->boardSize = N;
+                header->bucketCount = bucketCount;
+                header->lower = -SQUARES;
+                header->upper = SQUARES;
+                header->nodes = 0;
+                header->seconds = 0.0;
+            }
+            return true;
+        }
+
+        const Header& progress() const { return *header; }
+        size_t tableBytes() const { return solver.table.bytes(); }
+
+        // Whether Black's score from the start position is at least 'value', returned as a
+        // fail-soft bound, which is also recorded in the header.
+        int test(int value) {
+            uint64_t black, white;
+            startPosition(black, white);
+            {
+                std::lock_guard<std::mutex> lock(checkpointMutex);
+                solver.resetNodes();
+                recordedNodes = 0;
+                recordedAt = std::chrono::high_resolution_clock::now();
+            }
+            int bestSquare;
+            int score = solver.solve(black, white, value - 1, value, bestSquare);
+            if (score >= value) header->lower = std::max(header->lower, static_cast<int32_t>(score));
+            else header->upper = std::min(header->upper, static_cast<int32_t>(score));
+            checkpoint();
+            return score;
+        }
+
+        // Adds the work since the last checkpoint to the header totals and writes everything to
+        // disk, so that an interruption loses nothing up to here. Safe to call during a test.
+        void checkpoint() {
+            if (!view) return;
+            std::lock_guard<std::mutex> lock(checkpointMutex);
+            uint64_t nodes = countNodes();
+            auto now = std::chrono::high_resolution_clock::now();
+            header->nodes += nodes - recordedNodes;
+            header->seconds += std::chrono::duration<double>(now - recordedAt).count();
+            recordedNodes = nodes;
+            recordedAt = now;
+#ifdef _WIN32
+            FlushViewOfFile(view, 0);
+            FlushFileBuffers(fileHandle);
+#else
+            msync(view, viewSize, MS_SYNC);
+#endif
+        }
+
+        uint64_t countNodes() const { return solver.countNodes(); }
+
+        // Once the value is proven: moves (-1 for a pass) along which both sides keep it.
+        std::vector<int> principalLine() {
+            std::vector<int> line;
+            uint64_t player, opponent;
+            startPosition(player, opponent);
+            int value = header->lower;
+            while (true) {
+                if (!Solver::legalMoves(player, opponent)) {
+                    if (!Solver::legalMoves(opponent, player)) break;
+                    line.push_back(-1);
+                    std::swap(player, opponent);
+                    value = -value;
+                    continue;
+                }
+                // The window around the value makes the best move one that keeps it.
+                int square;
+                solver.solve(player, opponent, value - 1, value + 1, square);
+                line.push_back((square / BOARD_SIZE - OFFSET) * N + square % BOARD_SIZE - OFFSET);
+                uint64_t flipped = Bitboard::flips(square, player, opponent);
+                uint64_t nextPlayer = opponent ^ flipped;
+                opponent = player | flipped | (1ULL << square);
+                player = nextPlayer;
+                value = -value;
+            }
+            return line;
+        }
+
+        // Same four centre squares as on 8x8.
+        static void startPosition(uint64_t& black, uint64_t& white) {
+            black = Bitboard::squareBit(3, 4) | Bitboard::squareBit(4, 3);
+            white = Bitboard::squareBit(3, 3) | Bitboard::squareBit(4, 4);
+        }
+
+    private:
+        static const int OFFSET = (BOARD_SIZE - N) / 2;
+        using Bucket = EndgameTable::Bucket;
+
+        std::unique_ptr<WorkStealingPool> pool;
+        Solver solver;
+        Header* header = nullptr;
+        std::mutex checkpointMutex;
+        uint64_t recordedNodes = 0;
+        std::chrono::high_resolution_clock::time_point recordedAt = std::chrono::high_resolution_clock::now();
+        void* view = nullptr;
+        size_t viewSize = 0;
+#ifdef _WIN32
+        HANDLE fileHandle = INVALID_HANDLE_VALUE;
+        HANDLE mappingHandle = NULL;
+#endif
+
+        bool mapFile(const std::string& path, uint64_t fileSize, bool fresh) {
+#ifdef _WIN32
+            fileHandle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, fresh ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+            if (fileHandle == INVALID_HANDLE_VALUE) return false;
+            mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READWRITE, static_cast<DWORD>(fileSize >> 32), static_cast<DWORD>(fileSize), NULL);
+            view = mappingHandle ? MapViewOfFile(mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, 0) : nullptr;
+#else
+            int fd = ::open(path.c_str(), O_RDWR | O_CREAT | (fresh ? O_TRUNC : 0), 0644);
+            if (fd < 0) return false;
+            // A new file is sparse: disk space is only taken as the table fills.
+            if (fresh && ftruncate(fd, static_cast<off_t>(fileSize)) != 0) {
+                ::close(fd);
+                return false;
+            }
+            void* mapped = mmap(nullptr, static_cast<size_t>(fileSize), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            ::close(fd);
+            view = (mapped == MAP_FAILED) ? nullptr : mapped;
+#endif
+            viewSize = static_cast<size_t>(fileSize);
+            return view != nullptr;
+        }
+
+        void close() {
+            if (view) checkpoint();
+#ifdef _WIN32
+            if (view) UnmapViewOfFile(view);
+            if (mappingHandle) CloseHandle(mappingHandle);
+            if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+            mappingHandle = NULL;
+            fileHandle = INVALID_HANDLE_VALUE;
+#else
+            if (view) munmap(view, viewSize);
+#endif
+            view = nullptr;
+            viewSize = 0;
+            header = nullptr;
+        }
+    };
+}
+
+// Opening book: a sorted array of 64-bit entries, each a position key with its low byte replaced
+// by the book move, behind a 16-byte header (magic, entry count). Positions are stored in their
+// canonical orientation, the smallest of their eight symmetric images, so symmetric openings
+// share one entry. The file is memory-mapped and binary-searched in place.
+class OpeningBook {
+public:
+    static constexpr char MAGIC[8] = { 'O', 'T', 'H', 'B', 'O', 'O', 'K', '1' };
+    static const size_t HEADER_SIZE = 16;
+    static const uint64_t MOVE_MASK = 0xFF;
+
+    OpeningBook() = default;
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+    ~OpeningBook() { close(); }
+
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (fileHandle == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(HEADER_SIZE)) {
+            close();
+            return false;
+        }
+        mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+        view = mappingHandle ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        viewSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat fileInfo;
+        if (fstat(fd, &fileInfo) != 0 || fileInfo.st_size < static_cast<off_t>(HEADER_SIZE)) {
+            ::close(fd);
+            return false;
+        }
+        void* mapped = mmap(nullptr, static_cast<size_t>(fileInfo.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        view = (mapped == MAP_FAILED) ? nullptr : mapped;
+        viewSize = static_cast<size_t>(fileInfo.st_size);
+#endif
+        if (!view) {
+            close();
+            return false;
         }
-
-        std::vector<Move> validMoves = board.getValidMoves(currentPlayerTurn);
-
-        if (validMoves.empty()) {
-            return minimax(board, depth - 1, alpha, beta, !maximizingPlayer, aiPlayerPerspective, getOpponent(currentPlayerTurn));
+        const char* bytes = static_cast<const char*>(view);
+        uint64_t count;
+        std::memcpy(&count, bytes + sizeof(MAGIC), sizeof(count));
+        if (!std::equal(MAGIC, MAGIC + sizeof(MAGIC), bytes) || viewSize != HEADER_SIZE + count * sizeof(uint64_t)) {
+            close();
+            return false;
         }
+        entries = reinterpret_cast<const uint64_t*>(bytes + HEADER_SIZE);
+        entryCount = static_cast<size_t>(count);
+        return true;
+    }
 
-        std::shuffle(validMoves.begin(), validMoves.end(), rng);
+    void close() {
+#ifdef _WIN32
+        if (view) UnmapViewOfFile(view);
+        if (mappingHandle) CloseHandle(mappingHandle);
+        if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+        mappingHandle = NULL;
+        fileHandle = INVALID_HANDLE_VALUE;
+#else
+        if (view) munmap(const_cast<void*>(view), viewSize);
+#endif
+        view = nullptr;
+        viewSize = 0;
+        entries = nullptr;
+        entryCount = 0;
+    }
 
-        if (maximizingPlayer) {
-            int maxEval = std::numeric_limits<int>::min();
-            for (const auto& move : validMoves) {
-                Board nextBoard = board;
-                std::vector<Move> flips = nextBoard.getFlipsForMove(move.row, move.col, currentPlayerTurn);
-                nextBoard.applyMove(move, currentPlayerTurn, flips);
-                int eval = minimax(nextBoard, depth - 1, alpha, beta, false, aiPlayerPerspective, getOpponent(currentPlayerTurn));
-                maxEval = std::max(maxEval, eval);
-                alpha = std::max(alpha, eval);
-                if (beta <= alpha) break;
+    size_t size() const { return entryCount; }
+
+    bool probe(const Board& board, PlayerColor sideToMove, Move& move) const {
+        if (entryCount == 0) return false;
+        int symmetry = canonicalSymmetry(board.blackDiscs, board.whiteDiscs);
+        uint64_t key = positionKey(Bitboard::transform(board.blackDiscs, symmetry),
+            Bitboard::transform(board.whiteDiscs, symmetry), sideToMove) & ~MOVE_MASK;
+        const uint64_t* end = entries + entryCount;
+        const uint64_t* found = std::lower_bound(entries, end, key);
+        if (found == end || (*found & ~MOVE_MASK) != key) return false;
+
+        int canonicalSquare = static_cast<int>(*found & MOVE_MASK);
+        uint64_t legal = board.getValidMoveMask(sideToMove);
+        for (uint64_t b = legal; b; b &= b - 1) {
+            int sq = Bitboard::firstSquare(b);
+            if (Bitboard::transformSquare(sq, symmetry) == canonicalSquare) {
+                move = { sq / BOARD_SIZE, sq % BOARD_SIZE };
+                return true;
             }
-            return maxEval;
         }
-        else {
-            int minEval = std::numeric_limits<int>::max();
-            for (const auto& move : validMoves) {
-                Board nextBoard = board;
-                std::vector<Move> flips = nextBoard.getFlipsForMove(move.row, move.col, currentPlayerTurn);
-                nextBoard.applyMove(move, currentPlayerTurn, flips);
-                int eval = minimax(nextBoard, depth - 1, alpha, beta, true, aiPlayerPerspective, getOpponent(currentPlayerTurn));
-                minEval = std::min(minEval, eval);
-                beta = std::min(beta, eval);
-                if (beta <= alpha) break;
+        return false;
+    }
+
+    // The symmetry that maps the position to its canonical image.
+    static int canonicalSymmetry(uint64_t black, uint64_t white) {
+        int best = 0;
+        std::pair<uint64_t, uint64_t> smallest = { black, white };
+        for (int symmetry = 1; symmetry < 8; ++symmetry) {
+            std::pair<uint64_t, uint64_t> image = { Bitboard::transform(black, symmetry), Bitboard::transform(white, symmetry) };
+            if (image < smallest) {
+                smallest = image;
+                best = symmetry;
             }
-            return minEval;
         }
+        return best;
     }
+
+    static uint64_t positionKey(uint64_t black, uint64_t white, PlayerColor sideToMove) {
+        uint64_t key = (sideToMove == PlayerColor::WHITE) ? Zobrist::keys.whiteToMove : 0;
+        for (uint64_t b = black; b; b &= b - 1) key ^= Zobrist::discKey(PlayerColor::BLACK, Bitboard::firstSquare(b));
+        for (uint64_t b = white; b; b &= b - 1) key ^= Zobrist::discKey(PlayerColor::WHITE, Bitboard::firstSquare(b));
+        return key;
+    }
+
+private:
+    const void* view = nullptr;
+    size_t viewSize = 0;
+    const uint64_t* entries = nullptr;
+    size_t entryCount = 0;
+#ifdef _WIN32
+    HANDLE fileHandle = INVALID_HANDLE_VALUE;
+    HANDLE mappingHandle = NULL;
+#endif
 };
+constexpr char OpeningBook::MAGIC[8];
 
 class UIManager {
 public:
@@ -391,68 +2461,69 @@ public:
 
     UIManager() {
         infoPanelStartRow = boardOffsetY + BOARD_SIZE + 2;
+        invalidate();
     }
 
-    void drawBoard(const Board& board, const std::vector<Move>* validMoves, const Move* lastMove) {
-        Console::setCursorPosition(boardOffsetY - 1, boardOffsetX - 2);
-        printf("%s  ", Console::BOARD_BORDER_COLOR.c_str());
-        for (int c = 0; c < BOARD_SIZE; ++c) {
-            printf(" %c ", (char)('A' + c));
-        }
-        printf("%s\n", Console::RESET.c_str());
-
-        for (int r = 0; r < BOARD_SIZE; ++r) {
-            Console::setCursorPosition(boardOffsetY + r, boardOffsetX - 3);
-            printf("%s%2d %s", Console::FG_YELLOW.c_str(), r + 1, Console::RESET.c_str());
+    // Forgets what is on screen, so the next drawBoard repaints everything (after a clear screen).
+    void invalidate() {
+        frameDrawn = false;
+        std::fill(std::begin(shownCells), std::end(shownCells), CELL_UNKNOWN);
+    }
 
+    // Repaints only the cells that changed since the last call, as a single write. Squares in
+    // 'validMoveMask' are highlighted as move options.
+    void drawBoard(const Board& board, uint64_t validMoveMask, const Move* lastMove) {
+        frame.clear();
+        if (!frameDrawn) {
+            appendCursor(boardOffsetY - 1, boardOffsetX - 2);
+            frame += Console::BOARD_BORDER_COLOR;
+            frame += "  ";
             for (int c = 0; c < BOARD_SIZE; ++c) {
-                bool isLast = lastMove && lastMove->row == r && lastMove->col == c;
-                bool isValidOpt = false;
-                if (validMoves) {
-                    for (const auto& vm : *validMoves) {
-                        if (vm.row == r && vm.col == c) {
-                            isValidOpt = true;
-                            break;
-                        }
-                    }
-                }
-
-                std::string pieceCharStr = " ";
-                std::string pieceColor = Console::RESET;
-                std::string bgColor = Console::RESET;
-
-                if (board.grid[r][c] == Piece::BLACK_PIECE) {
-                    pieceCharStr = std::string(1, Console::PIECE_CHAR);
-                    pieceColor = Console::PIECE_BLACK_DISPLAY_COLOR;
-                }
-                else if (board.grid[r][c] == Piece::WHITE_PIECE) {
-                    pieceCharStr = std::string(1, Console::PIECE_CHAR);
-                    pieceColor = Console::PIECE_WHITE_DISPLAY_COLOR;
-                }
-                else {
-                    if (isValidOpt) {
-                        pieceCharStr = std::string(1, Console::VALID_MOVE_CHAR);
-                        bgColor = Console::VALID_MOVE_BG_COLOR;
-                        pieceColor = Console::VALID_MOVE_FG_COLOR;
-                    }
-                    else {
-                        pieceCharStr = std::string(1, Console::EMPTY_CELL_CHAR);
-                        pieceColor = Console::EMPTY_CELL_CHAR_COLOR;
-                    }
-                }
-
-                if (isLast) {
-                    bgColor = Console::LAST_MOVE_BG_COLOR;
-                }
+                frame += ' ';
+                frame += static_cast<char>('A' + c);
+                frame += ' ';
+            }
+            frame += Console::RESET;
+            for (int r = 0; r < BOARD_SIZE; ++r) {
+                char label[32];
+                snprintf(label, sizeof(label), "%2d ", r + 1);
+                appendCursor(boardOffsetY + r, boardOffsetX - 3);
+                frame += Console::FG_YELLOW;
+                frame += label;
+                frame += Console::RESET;
+            }
+            frameDrawn = true;
+        }
 
-                printf("%s%s%*s%*s%s",
-                    bgColor.c_str(),
-                    pieceColor.c_str(),
-                    (cellDisplayWidth - 1) / 2 + 1, pieceCharStr.c_str(),
-                    (cellDisplayWidth - 1) - (cellDisplayWidth - 1) / 2, "",
-                    Console::RESET.c_str());
+        int lastSquare = (lastMove && lastMove->isValid()) ? lastMove->row * BOARD_SIZE + lastMove->col : -1;
+        for (int sq = 0; sq < BOARD_SIZE * BOARD_SIZE; ++sq) {
+            uint64_t bit = 1ULL << sq;
+            uint8_t cell = (board.blackDiscs & bit) ? CELL_BLACK
+                : (board.whiteDiscs & bit) ? CELL_WHITE
+                : (validMoveMask & bit) ? CELL_VALID_MOVE : CELL_EMPTY;
+            if (sq == lastSquare) cell |= CELL_LAST_MOVE;
+            if (cell == shownCells[sq]) continue;
+            shownCells[sq] = cell;
+
+            const std::string* pieceColor = &Console::EMPTY_CELL_CHAR_COLOR;
+            char pieceChar = Console::EMPTY_CELL_CHAR;
+            switch (cell & ~CELL_LAST_MOVE) {
+            case CELL_BLACK: pieceColor = &Console::PIECE_BLACK_DISPLAY_COLOR; pieceChar = Console::PIECE_CHAR; break;
+            case CELL_WHITE: pieceColor = &Console::PIECE_WHITE_DISPLAY_COLOR; pieceChar = Console::PIECE_CHAR; break;
+            case CELL_VALID_MOVE: pieceColor = &Console::VALID_MOVE_FG_COLOR; pieceChar = Console::VALID_MOVE_CHAR; break;
             }
-            printf("%s\n", Console::RESET.c_str());
+            appendCursor(boardOffsetY + sq / BOARD_SIZE, boardOffsetX + (sq % BOARD_SIZE) * cellDisplayWidth);
+            if (cell & CELL_LAST_MOVE) frame += Console::LAST_MOVE_BG_COLOR;
+            else if ((cell & ~CELL_LAST_MOVE) == CELL_VALID_MOVE) frame += Console::VALID_MOVE_BG_COLOR;
+            frame += *pieceColor;
+            frame.append((cellDisplayWidth - 1) / 2, ' ');
+            frame += pieceChar;
+            frame.append((cellDisplayWidth - 1) - (cellDisplayWidth - 1) / 2, ' ');
+            frame += Console::RESET;
+        }
+        if (!frame.empty()) {
+            fwrite(frame.data(), 1, frame.size(), stdout);
+            fflush(stdout);
         }
     }
 
@@ -568,6 +2639,24 @@ public:
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         }
     }
+
+private:
+    // Per-cell display state: what the cell holds, plus a flag for the last-move highlight.
+    enum CellState : uint8_t {
+        CELL_EMPTY, CELL_BLACK, CELL_WHITE, CELL_VALID_MOVE,
+        CELL_LAST_MOVE = 4,
+        CELL_UNKNOWN = 0xFF
+    };
+    uint8_t shownCells[BOARD_SIZE * BOARD_SIZE];
+    bool frameDrawn = false;
+    // Reused between frames so drawing does not allocate.
+    std::string frame;
+
+    void appendCursor(int row, int col) {
+        char escape[32];
+        snprintf(escape, sizeof(escape), "\033[%d;%dH", row + 1, col + 1);
+        frame += escape;
+    }
 };
 
 class GameManager {
@@ -575,14 +2664,20 @@ public:
     Board board;
     PlayerColor currentPlayer;
     AIPlayer ai;
+    OpeningBook book;
     UIManager ui;
     PlayerColor humanPlayer;
     Move lastMovePlayed = { -1, -1 };
+    // Let the AI search while the human is thinking.
+    bool ponder;
 
-    GameManager(PlayerColor humanAs, int aiSearchDepth = 4, int aiTimeLimitMs = 2000)
+    GameManager(PlayerColor humanAs, int aiSearchDepth = 4, int aiTimeLimitMs = 2000, int aiThreads = 1,
+        const std::string& bookPath = "othello_book.bin", bool aiPonders = true)
         : currentPlayer(PlayerColor::BLACK),
-        ai(aiSearchDepth, aiTimeLimitMs),
-        humanPlayer(humanAs) {
+        ai(aiSearchDepth, aiTimeLimitMs, aiThreads),
+        humanPlayer(humanAs),
+        ponder(aiPonders) {
+        book.open(bookPath);
         Console::clearScreen();
         Console::hideCursor();
         Console::setCursorPosition(0, 0);
@@ -605,7 +2700,7 @@ public:
             auto scores = board.getScore();
             std::vector<Move> validMoves = board.getValidMoves(currentPlayer);
 
-            ui.drawBoard(board, (currentPlayer == humanPlayer ? &validMoves : nullptr), &lastMovePlayed);
+            ui.drawBoard(board, (currentPlayer == humanPlayer ? board.getValidMoveMask(currentPlayer) : 0), &lastMovePlayed);
             ui.displayInfo(currentPlayer, humanPlayer, scores.first, scores.second, message, aiMessageAddendum);
             aiMessageAddendum = ""; // Clear AI addendum after displaying it once
 
@@ -631,7 +2726,9 @@ public:
             }
 
             if (currentPlayer == humanPlayer) {
+                if (ponder) ai.startPondering(board, humanPlayer);
                 Move humanMove = ui.getHumanInput(validMoves, humanPlayer, scores.first, scores.second);
+                ai.stopPondering();
                 if (humanMove.row == -2 && humanMove.col == -2) {
                     gameRunning = false;
                     message = "Input error, exiting game.";
@@ -648,7 +2745,11 @@ public:
                 Console::pause(100);
 
                 auto aiStartTime = std::chrono::high_resolution_clock::now();
-                Move aiMove = ai.findBestMoveIterativeDeepening(board, currentPlayer);
+                Move aiMove;
+                bool bookMove = book.probe(board, currentPlayer, aiMove);
+                if (!bookMove) {
+                    aiMove = ai.findBestMoveIterativeDeepening(board, currentPlayer);
+                }
                 auto aiEndTime = std::chrono::high_resolution_clock::now();
                 auto aiDuration = std::chrono::duration_cast<std::chrono::milliseconds>(aiEndTime - aiStartTime);
 
@@ -658,7 +2759,23 @@ public:
                     lastMovePlayed = aiMove;
                     message = "AI played " + std::string(1, (char)('A' + aiMove.col)) + std::to_string(aiMove.row + 1) +
                         ". Flipped " + std::to_string(flips.size()) + " pieces. Your turn.";
-                    aiMessageAddendum = "(Took " + std::to_string(aiDuration.count()) + "ms)";
+                    std::ostringstream stats;
+                    if (bookMove) {
+                        stats << "(Book move)";
+                    }
+                    else if (ai.lastMoveSolved) {
+                        const char* outcome = (ai.lastSolveScore > 0) ? "win" : (ai.lastSolveScore < 0) ? "loss" : "draw";
+                        stats << "(Solved: " << outcome;
+                        if (ai.lastSolveExact && ai.lastSolveScore != 0) stats << " by " << std::abs(ai.lastSolveScore);
+                        stats << ", " << aiDuration.count() << "ms, " << ai.nodesSearched << " nodes)";
+                    }
+                    else {
+                        stats << "(Took " << aiDuration.count() << "ms, depth " << ai.completedDepth << ", " << ai.nodesSearched << " nodes, EBF "
+                            << std::fixed << std::setprecision(2) << ai.effectiveBranchingFactor;
+                        if (ai.ponderNodes > 0) stats << ", pondered " << ai.ponderNodes << " nodes";
+                        stats << ")";
+                    }
+                    aiMessageAddendum = stats.str();
                 }
                 else {
                     message = "AI passes (no valid moves). Your turn.";
@@ -669,7 +2786,7 @@ public:
         }
 
         auto finalScores = board.getScore();
-        ui.drawBoard(board, nullptr, &lastMovePlayed);
+        ui.drawBoard(board, 0, &lastMovePlayed);
         ui.displayInfo(PlayerColor::NONE, humanPlayer, finalScores.first, finalScores.second, message);
 
         Console::setCursorPosition(ui.infoPanelStartRow + 5, 0);
@@ -688,10 +2805,1097 @@ public:
     }
 };
 
-int main() {
+// Searches a fixed set of openings to a fixed depth with 1, 2, 4, ... threads and maxThreads, and
+// prints how the time scales. Each player and its thread pool are built, and warmed up with one
+// untimed search, before the clock starts; every position starts from empty hash tables so the
+// numbers are comparable.
+void runThreadScaling(int maxThreads, int depth) {
+    std::vector<std::pair<Board, PlayerColor>> positions;
+    std::mt19937 openingRng(2024);
+    while (positions.size() < 6) {
+        Board board;
+        PlayerColor side = PlayerColor::BLACK;
+        for (int ply = 0; ply < 12; ++ply) {
+            std::vector<Move> moves = board.getValidMoves(side);
+            if (moves.empty()) break;
+            Move move = moves[openingRng() % moves.size()];
+            board.makeMove(move.row * BOARD_SIZE + move.col, side);
+            side = getOpponent(side);
+        }
+        if (!board.getValidMoves(side).empty()) positions.push_back({ board, side });
+    }
+
+    maxThreads = std::max(1, maxThreads);
+    std::vector<int> counts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) counts.push_back(threads);
+    counts.push_back(maxThreads);
+
+    printf("Thread scaling, depth %d, %zu positions (%u hardware threads)\n", depth, positions.size(), std::thread::hardware_concurrency());
+    printf("%8s %10s %12s %12s %8s\n", "threads", "time ms", "nodes", "nodes/s", "speedup");
+    double baselineMs = 0.0;
+    for (int threads : counts) {
+        AIPlayer ai(depth, 1000000, threads);
+        ai.findBestMoveIterativeDeepening(positions[0].first, positions[0].second);
+        uint64_t nodes = 0;
+        double ms = 0.0;
+        for (const auto& position : positions) {
+            ai.transpositionTable.clear();
+            ai.endgameSolver.clear();
+            auto start = std::chrono::high_resolution_clock::now();
+            ai.findBestMoveIterativeDeepening(position.first, position.second);
+            ms += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+            nodes += ai.nodesSearched;
+        }
+        if (threads == 1) baselineMs = ms;
+        printf("%8d %10.0f %12llu %12.0f %7.2fx\n", threads, ms, static_cast<unsigned long long>(nodes),
+            nodes / std::max(ms / 1000.0, 1e-9), baselineMs / std::max(ms, 1e-9));
+    }
+}
+
+// Self-play data: a magic string, then one 18-byte record per position - the black and white
+// bitboards, the final disc difference for Black (empty squares going to the winner) and the side
+// to move (0 Black, 1 White), which the disc count alone gets wrong after a pass.
+const char SELFPLAY_MAGIC[8] = { 'O', 'T', 'H', 'S', 'E', 'L', 'F', '2' };
+const size_t SELFPLAY_RECORD_SIZE = 2 * sizeof(uint64_t) + 2;
+
+// Plays 'games' engine-vs-engine games across 'threads' threads and writes every searched
+// position to 'path'. Each game opens with a few random moves; the rest is played by AIPlayer at
+// a fixed depth, with exact endgame solves. Every game is seeded by its number, so a run can be
+// repeated: the same games come out whatever the thread count, in the order they finish.
+bool runSelfPlay(int games, const std::string& path, int threads, int depth) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        printf("Cannot write %s\n", path.c_str());
+        return false;
+    }
+    file.write(SELFPLAY_MAGIC, sizeof(SELFPLAY_MAGIC));
+
+    const int SOLVE_EMPTIES = 14;
+    std::atomic<int> nextGame{ 0 };
+    std::atomic<int> finishedGames{ 0 };
+    std::atomic<uint64_t> positionsWritten{ 0 };
+    std::mutex fileMutex;
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    auto worker = [&]() {
+        AIPlayer ai(depth, std::numeric_limits<int>::max(), 1, 4);
+        ai.exactSolveEmpties = ai.wldSolveEmpties = SOLVE_EMPTIES;
+        std::vector<char> buffer;
+        for (int game = nextGame++; game < games; game = nextGame++) {
+            // Everything a game depends on starts afresh from the game number, so the games come
+            // out the same whichever thread plays them.
+            ai.rng.seed(game);
+            ai.transpositionTable.clear();
+            ai.endgameSolver.clear();
+            std::mt19937 openingRng(game);
+            int openingPlies = 6 + game % 7;
+            Board board;
+            PlayerColor side = PlayerColor::BLACK;
+            std::vector<std::pair<Board, PlayerColor>> positions;
+            for (int ply = 0; !board.isGameOver(); ++ply) {
+                std::vector<Move> moves = board.getValidMoves(side);
+                if (moves.empty()) {
+                    side = getOpponent(side);
+                    continue;
+                }
+                Move move;
+                if (ply < openingPlies) {
+                    move = moves[openingRng() % moves.size()];
+                }
+                else {
+                    positions.push_back({ board, side });
+                    move = ai.findBestMoveIterativeDeepening(board, side);
+                }
+                board.makeMove(move.row * BOARD_SIZE + move.col, side);
+                side = getOpponent(side);
+            }
+
+            int8_t result = static_cast<int8_t>(EndgameSolver::finalScore(board.blackDiscs, board.whiteDiscs));
+            buffer.clear();
+            for (const auto& position : positions) {
+                const char* black = reinterpret_cast<const char*>(&position.first.blackDiscs);
+                const char* white = reinterpret_cast<const char*>(&position.first.whiteDiscs);
+                buffer.insert(buffer.end(), black, black + sizeof(uint64_t));
+                buffer.insert(buffer.end(), white, white + sizeof(uint64_t));
+                buffer.push_back(static_cast<char>(result));
+                buffer.push_back(static_cast<char>(position.second == PlayerColor::WHITE ? 1 : 0));
+            }
+            std::lock_guard<std::mutex> lock(fileMutex);
+            file.write(buffer.data(), buffer.size());
+            positionsWritten += positions.size();
+            int finished = ++finishedGames;
+            if (finished % 10 == 0 || finished == games) {
+                double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+                printf("\r%d/%d games, %llu positions, %.1f games/s", finished, games,
+                    static_cast<unsigned long long>(positionsWritten.load()), finished / std::max(seconds, 1e-9));
+                fflush(stdout);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) workers.emplace_back(worker);
+    for (auto& w : workers) w.join();
+    printf("\nWrote %s\n", path.c_str());
+    return static_cast<bool>(file);
+}
+
+// Fits the pattern, mobility and stability weights to self-play results by least squares: full-batch
+// gradient descent, each weight stepping by its mean residual, with the gradient summed over
+// 'threads' slices of the data. Training starts from the weights currently loaded, first scaled
+// as a whole to fit the data, so entries that never occur in it keep a sensible value. Every
+// tenth position is held out to show how well the fit generalises.
+bool runTraining(const std::string& dataPath, const std::string& weightsPath, int threads, int epochs) {
+    // Evaluation units per disc of final margin.
+    const double DISC_UNIT = 100.0;
+    // Every position touches INSTANCE_COUNT weights, so each one takes that share of its residual.
+    const double LEARNING_RATE = 1.0 / Patterns::INSTANCE_COUNT;
+    // Added to a weight's occurrence count, so that rarely seen entries move less.
+    const double RARE_ENTRY_DAMPING = 4.0;
+    const size_t HOLDOUT_EVERY = 10;
+
+    std::ifstream file(dataPath, std::ios::binary);
+    char magic[sizeof(SELFPLAY_MAGIC)];
+    if (!file || !file.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), SELFPLAY_MAGIC)) {
+        printf("%s is not a self-play file\n", dataPath.c_str());
+        return false;
+    }
+
+    struct Sample {
+        uint32_t feature[Patterns::INSTANCE_COUNT];
+        uint8_t stage;
+        int8_t mobility;
+        int8_t stability;
+        float target;
+    };
+    std::vector<Sample> samples, holdout;
+    char record[SELFPLAY_RECORD_SIZE];
+    for (size_t recordIndex = 0; file.read(record, sizeof(record)); ++recordIndex) {
+        Board board;
+        std::memcpy(&board.blackDiscs, record, sizeof(uint64_t));
+        std::memcpy(&board.whiteDiscs, record + sizeof(uint64_t), sizeof(uint64_t));
+        board.computePatternIndices();
+        Sample sample;
+        sample.stage = static_cast<uint8_t>(Patterns::stageOf(Bitboard::popCount(board.blackDiscs | board.whiteDiscs)));
+        for (int i = 0; i < Patterns::INSTANCE_COUNT; ++i) {
+            sample.feature[i] = sample.stage * Patterns::geometry.stageSize + Patterns::geometry.instanceOffset[i] + board.patternIndex[i];
+        }
+        sample.mobility = static_cast<int8_t>(Bitboard::popCount(board.getValidMoveMask(PlayerColor::BLACK)) -
+            Bitboard::popCount(board.getValidMoveMask(PlayerColor::WHITE)));
+        sample.stability = static_cast<int8_t>(Bitboard::popCount(Bitboard::stableDiscs(board.blackDiscs, board.whiteDiscs)) -
+            Bitboard::popCount(Bitboard::stableDiscs(board.whiteDiscs, board.blackDiscs)));
+        sample.target = static_cast<float>(static_cast<int8_t>(record[2 * sizeof(uint64_t)]) * DISC_UNIT);
+        (recordIndex % HOLDOUT_EVERY == HOLDOUT_EVERY - 1 ? holdout : samples).push_back(sample);
+    }
+    if (samples.empty()) {
+        printf("No positions in %s\n", dataPath.c_str());
+        return false;
+    }
+    printf("Training on %zu positions (%zu held out) with %d threads\n", samples.size(), holdout.size(), threads);
+
+    const Patterns::Weights& initial = Patterns::weights();
+    std::vector<double> weights(initial.values.begin(), initial.values.end());
+    double mobility[Patterns::STAGE_COUNT];
+    double stability[Patterns::STAGE_COUNT];
+    for (int s = 0; s < Patterns::STAGE_COUNT; ++s) {
+        mobility[s] = initial.mobility[s];
+        stability[s] = initial.stability[s];
+    }
+    auto predict = [&](const Sample& sample) {
+        double predicted = mobility[sample.stage] * sample.mobility + stability[sample.stage] * sample.stability;
+        for (uint32_t f : sample.feature) predicted += weights[f];
+        return predicted;
+    };
+    auto rmsError = [&](const std::vector<Sample>& set) {
+        double squaredError = 0.0;
+        for (const Sample& sample : set) squaredError += (sample.target - predict(sample)) * (sample.target - predict(sample));
+        return set.empty() ? 0.0 : std::sqrt(squaredError / set.size()) / DISC_UNIT;
+    };
+
+    double predictedTimesTarget = 0.0, predictedSquared = 0.0;
+    for (const Sample& sample : samples) {
+        double predicted = predict(sample);
+        predictedTimesTarget += predicted * sample.target;
+        predictedSquared += predicted * predicted;
+    }
+    double scale = (predictedSquared > 0.0) ? predictedTimesTarget / predictedSquared : 1.0;
+    for (double& w : weights) w *= scale;
+    for (double& m : mobility) m *= scale;
+    for (double& m : stability) m *= scale;
+    printf("Starting weights scaled by %.3f\n", scale);
+
+    std::vector<uint32_t> occurrences(weights.size(), 0);
+    double mobilitySquares[Patterns::STAGE_COUNT] = {}, stabilitySquares[Patterns::STAGE_COUNT] = {};
+    for (const Sample& sample : samples) {
+        for (uint32_t f : sample.feature) occurrences[f]++;
+        mobilitySquares[sample.stage] += sample.mobility * sample.mobility;
+        stabilitySquares[sample.stage] += sample.stability * sample.stability;
+    }
+
+    struct Gradient {
+        std::vector<double> weights;
+        double mobility[Patterns::STAGE_COUNT];
+        double stability[Patterns::STAGE_COUNT];
+        double squaredError;
+    };
+    std::vector<Gradient> gradients(threads);
+    for (auto& g : gradients) g.weights.assign(weights.size(), 0.0);
+
+    for (int epoch = 1; epoch <= epochs; ++epoch) {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                Gradient& g = gradients[t];
+                std::fill(g.weights.begin(), g.weights.end(), 0.0);
+                std::fill(std::begin(g.mobility), std::end(g.mobility), 0.0);
+                std::fill(std::begin(g.stability), std::end(g.stability), 0.0);
+                g.squaredError = 0.0;
+                size_t begin = samples.size() * t / threads, end = samples.size() * (t + 1) / threads;
+                for (size_t i = begin; i < end; ++i) {
+                    const Sample& sample = samples[i];
+                    double residual = sample.target - predict(sample);
+                    for (uint32_t f : sample.feature) g.weights[f] += residual;
+                    g.mobility[sample.stage] += residual * sample.mobility;
+                    g.stability[sample.stage] += residual * sample.stability;
+                    g.squaredError += residual * residual;
+                }
+            });
+        }
+        for (auto& w : workers) w.join();
+
+        double squaredError = 0.0;
+        for (size_t f = 0; f < weights.size(); ++f) {
+            if (occurrences[f] == 0) continue;
+            double sum = 0.0;
+            for (const auto& g : gradients) sum += g.weights[f];
+            weights[f] += LEARNING_RATE * sum / (occurrences[f] + RARE_ENTRY_DAMPING);
+        }
+        for (int s = 0; s < Patterns::STAGE_COUNT; ++s) {
+            double sum = 0.0, stabilitySum = 0.0;
+            for (const auto& g : gradients) {
+                sum += g.mobility[s];
+                stabilitySum += g.stability[s];
+            }
+            if (mobilitySquares[s] > 0) mobility[s] += LEARNING_RATE * sum / mobilitySquares[s];
+            if (stabilitySquares[s] > 0) stability[s] += LEARNING_RATE * stabilitySum / stabilitySquares[s];
+        }
+        for (const auto& g : gradients) squaredError += g.squaredError;
+        if (epoch == 1 || epoch % 10 == 0 || epoch == epochs) {
+            printf("epoch %4d: rms error %.2f discs, held out %.2f\n", epoch,
+                std::sqrt(squaredError / samples.size()) / DISC_UNIT, rmsError(holdout));
+        }
+    }
+
+    Patterns::Weights trained;
+    for (size_t f = 0; f < weights.size(); ++f) {
+        trained.values[f] = static_cast<int16_t>(std::max(-32767.0, std::min(32767.0, std::round(weights[f]))));
+    }
+    for (int s = 0; s < Patterns::STAGE_COUNT; ++s) {
+        trained.mobility[s] = static_cast<int16_t>(std::max(-32767.0, std::min(32767.0, std::round(mobility[s]))));
+        trained.stability[s] = static_cast<int16_t>(std::max(-32767.0, std::min(32767.0, std::round(stability[s]))));
+    }
+    if (!Patterns::saveWeights(trained, weightsPath)) {
+        printf("Cannot write %s\n", weightsPath.c_str());
+        return false;
+    }
+    printf("Wrote %s\n", weightsPath.c_str());
+    return true;
+}
+
+// Fits the Multi-ProbCut parameters: for up to 'positionsPerStage' self-play positions of each
+// stage, searches depths 1..ProbCut::MAX_DEPTH without pruning and regresses every depth's score
+// on its shallow depth's score. Stage/depth cells with too few samples keep their defaults.
+bool runProbCutFit(const std::string& dataPath, const std::string& paramsPath, int threads, int positionsPerStage) {
+    const size_t MIN_SAMPLES = 20;
+
+    std::ifstream file(dataPath, std::ios::binary);
+    char magic[sizeof(SELFPLAY_MAGIC)];
+    if (!file || !file.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), SELFPLAY_MAGIC)) {
+        printf("%s is not a self-play file\n", dataPath.c_str());
+        return false;
+    }
+
+    struct Position {
+        Board board;
+        PlayerColor sideToMove;
+        int stage;
+    };
+    std::vector<std::vector<Position>> byStage(Patterns::STAGE_COUNT);
+    char record[SELFPLAY_RECORD_SIZE];
+    while (file.read(record, sizeof(record))) {
+        Position position;
+        std::memcpy(&position.board.blackDiscs, record, sizeof(uint64_t));
+        std::memcpy(&position.board.whiteDiscs, record + sizeof(uint64_t), sizeof(uint64_t));
+        position.board.hash = position.board.computeHash();
+        position.board.computePatternIndices();
+        int discs = Bitboard::popCount(position.board.blackDiscs | position.board.whiteDiscs);
+        position.sideToMove = record[2 * sizeof(uint64_t) + 1] ? PlayerColor::WHITE : PlayerColor::BLACK;
+        if (position.board.getValidMoveMask(position.sideToMove) == 0) continue;
+        position.stage = Patterns::stageOf(discs);
+        byStage[position.stage].push_back(position);
+    }
+    std::vector<Position> positions;
+    std::mt19937 rng(12345);
+    for (auto& stagePositions : byStage) {
+        std::shuffle(stagePositions.begin(), stagePositions.end(), rng);
+        if (stagePositions.size() > static_cast<size_t>(positionsPerStage)) stagePositions.resize(positionsPerStage);
+        positions.insert(positions.end(), stagePositions.begin(), stagePositions.end());
+    }
+    if (positions.empty()) {
+        printf("No positions in %s\n", dataPath.c_str());
+        return false;
+    }
+    printf("Searching %zu positions to depth %d with %d threads\n", positions.size(), ProbCut::MAX_DEPTH, threads);
+
+    // scores[i][d] is position i searched to depth d; searched[i] once every depth completed.
+    std::vector<std::array<int, ProbCut::MAX_DEPTH + 1>> scores(positions.size());
+    std::vector<char> searched(positions.size(), 0);
+    std::atomic<size_t> nextPosition{ 0 };
+    std::atomic<size_t> finished{ 0 };
+    auto worker = [&]() {
+        AIPlayer ai(1, std::numeric_limits<int>::max(), 1);
+        ai.exactSolveEmpties = ai.wldSolveEmpties = -1;
+        ai.probCutConfidence = 0.0;
+        ai.searchForcedMoves = true; // Otherwise a forced move has no score at any depth
+        for (size_t i; (i = nextPosition.fetch_add(1)) < positions.size();) {
+            bool complete = true;
+            for (int depth = 1; depth <= ProbCut::MAX_DEPTH; ++depth) {
+                ai.maxDepth = depth;
+                ai.findBestMoveIterativeDeepening(positions[i].board, positions[i].sideToMove);
+                complete = complete && ai.completedDepth == depth;
+                scores[i][depth] = ai.lastScore;
+            }
+            searched[i] = complete;
+            size_t done = finished.fetch_add(1) + 1;
+            if (done % 20 == 0 || done == positions.size()) {
+                printf("\r%zu/%zu positions", done, positions.size());
+                fflush(stdout);
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) workers.emplace_back(worker);
+    for (auto& w : workers) w.join();
+
+    ProbCut::Table table = ProbCut::makeDefaultParams();
+    printf("\n%5s %5s %7s %8s %8s %8s\n", "stage", "depth", "samples", "a", "b", "sigma");
+    for (int stage = 0; stage < Patterns::STAGE_COUNT; ++stage) {
+        for (int depth = ProbCut::MIN_DEPTH; depth <= ProbCut::MAX_DEPTH; ++depth) {
+            int shallow = ProbCut::shallowDepth(depth);
+            double n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+            std::vector<std::pair<double, double>> pairs;
+            for (size_t i = 0; i < positions.size(); ++i) {
+                if (positions[i].stage != stage || !searched[i]) continue;
+                double x = scores[i][shallow], y = scores[i][depth];
+                if (std::abs(x) >= ProbCut::MAX_MODEL_SCORE || std::abs(y) >= ProbCut::MAX_MODEL_SCORE) continue;
+                pairs.push_back({ x, y });
+                n += 1; sx += x; sy += y; sxx += x * x; sxy += x * y;
+            }
+            double variance = n * sxx - sx * sx;
+            if (pairs.size() < MIN_SAMPLES || variance <= 0.0) continue;
+            double a = (n * sxy - sx * sy) / variance;
+            double b = (sy - a * sx) / n;
+            double squaredError = 0.0;
+            for (const auto& xy : pairs) squaredError += (xy.second - a * xy.first - b) * (xy.second - a * xy.first - b);
+            // A slope near zero would make the cut bounds explode; such a fit says nothing anyway.
+            if (a < 0.5) continue;
+            ProbCut::Params& p = table[stage][depth];
+            p.a = static_cast<float>(a);
+            p.b = static_cast<float>(b);
+            p.sigma = static_cast<float>(std::sqrt(squaredError / (n - 2)));
+            printf("%5d %5d %7zu %8.3f %8.1f %8.1f\n", stage, depth, pairs.size(), p.a, p.b, p.sigma);
+        }
+    }
+    if (!ProbCut::saveParams(table, paramsPath)) {
+        printf("Cannot write %s\n", paramsPath.c_str());
+        return false;
+    }
+    ProbCut::params() = table;
+    printf("Wrote %s\n", paramsPath.c_str());
+    return true;
+}
+
+// Builds the opening book: every position up to 'plies' moves from the start, deduplicated under
+// the board symmetries, is expanded; the positions at the last ply are scored by a 'depth' search
+// on 'threads' threads, and the scores are backed up by negamax to pick a move for every position
+// before them.
+bool runBookBuilder(const std::string& path, int plies, int depth, int threads) {
+    struct Node {
+        uint64_t black, white;
+        PlayerColor sideToMove;
+        int score;
+        int bestMove;
+    };
+    auto canonicalNode = [](uint64_t black, uint64_t white, PlayerColor side) {
+        int symmetry = OpeningBook::canonicalSymmetry(black, white);
+        return Node{ Bitboard::transform(black, symmetry), Bitboard::transform(white, symmetry), side, 0, -1 };
+    };
+    auto children = [](const Node& node) {
+        std::vector<std::pair<int, Node>> result;
+        uint64_t player = (node.sideToMove == PlayerColor::BLACK) ? node.black : node.white;
+        uint64_t opponent = (node.sideToMove == PlayerColor::BLACK) ? node.white : node.black;
+        PlayerColor next = getOpponent(node.sideToMove);
+        for (uint64_t moves = Bitboard::legalMoves(player, opponent); moves; moves &= moves - 1) {
+            int sq = Bitboard::firstSquare(moves);
+            uint64_t flipped = Bitboard::flips(sq, player, opponent);
+            uint64_t newPlayer = player | flipped | (1ULL << sq), newOpponent = opponent ^ flipped;
+            bool blackMoved = node.sideToMove == PlayerColor::BLACK;
+            result.push_back({ sq, Node{ blackMoved ? newPlayer : newOpponent, blackMoved ? newOpponent : newPlayer, next, 0, -1 } });
+        }
+        return result;
+    };
+    // Positions where the side to move must pass (or the game is over) are not expanded further.
+    auto staticScore = [](const Node& node) {
+        Board board;
+        board.blackDiscs = node.black;
+        board.whiteDiscs = node.white;
+        board.computePatternIndices();
+        return board.evaluate(node.sideToMove);
+    };
+
+    std::vector<std::unordered_map<uint64_t, Node>> levels(plies + 1);
+    Board start;
+    Node root = canonicalNode(start.blackDiscs, start.whiteDiscs, PlayerColor::BLACK);
+    levels[0][OpeningBook::positionKey(root.black, root.white, root.sideToMove)] = root;
+    for (int ply = 0; ply < plies; ++ply) {
+        for (const auto& entry : levels[ply]) {
+            for (const auto& child : children(entry.second)) {
+                Node node = canonicalNode(child.second.black, child.second.white, child.second.sideToMove);
+                levels[ply + 1].emplace(OpeningBook::positionKey(node.black, node.white, node.sideToMove), node);
+            }
+        }
+        printf("ply %d: %zu positions\n", ply + 1, levels[ply + 1].size());
+    }
+
+    std::vector<Node*> leaves;
+    for (auto& entry : levels[plies]) leaves.push_back(&entry.second);
+    std::atomic<size_t> nextLeaf{ 0 };
+    std::atomic<size_t> scoredLeaves{ 0 };
+    auto scoreLeaves = [&]() {
+        AIPlayer ai(depth, std::numeric_limits<int>::max(), 1, 16);
+        ai.searchForcedMoves = true; // Every leaf needs a score of its own
+        for (size_t i = nextLeaf++; i < leaves.size(); i = nextLeaf++) {
+            Node& leaf = *leaves[i];
+            Board board;
+            board.blackDiscs = leaf.black;
+            board.whiteDiscs = leaf.white;
+            board.hash = board.computeHash();
+            board.computePatternIndices();
+            if (board.getValidMoveMask(leaf.sideToMove) == 0) {
+                leaf.score = staticScore(leaf);
+            }
+            else {
+                ai.findBestMoveIterativeDeepening(board, leaf.sideToMove);
+                leaf.score = ai.lastScore;
+            }
+            size_t scored = ++scoredLeaves;
+            if (scored % 100 == 0 || scored == leaves.size()) {
+                printf("\rScored %zu/%zu leaf positions", scored, leaves.size());
+                fflush(stdout);
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) workers.emplace_back(scoreLeaves);
+    for (auto& w : workers) w.join();
+    printf("\n");
+
+    std::vector<uint64_t> entries;
+    for (int ply = plies - 1; ply >= 0; --ply) {
+        for (auto& entry : levels[ply]) {
+            Node& node = entry.second;
+            node.score = -SCORE_INFINITY;
+            for (const auto& child : children(node)) {
+                Node image = canonicalNode(child.second.black, child.second.white, child.second.sideToMove);
+                const Node& scored = levels[ply + 1].at(OpeningBook::positionKey(image.black, image.white, image.sideToMove));
+                if (-scored.score > node.score) {
+                    node.score = -scored.score;
+                    node.bestMove = child.first;
+                }
+            }
+            if (node.bestMove < 0) {
+                node.score = staticScore(node);
+            }
+            else {
+                entries.push_back((entry.first & ~OpeningBook::MOVE_MASK) | static_cast<uint64_t>(node.bestMove));
+            }
+        }
+    }
+    std::sort(entries.begin(), entries.end());
+
+    std::ofstream file(path, std::ios::binary);
+    uint64_t count = entries.size();
+    file.write(OpeningBook::MAGIC, sizeof(OpeningBook::MAGIC));
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(uint64_t));
+    if (!file) {
+        printf("Cannot write %s\n", path.c_str());
+        return false;
+    }
+    printf("Wrote %zu book positions to %s\n", entries.size(), path.c_str());
+    return true;
+}
+
+// Reads a board in .obf notation from the first N * N characters of 'squares'. Returns false if
+// the string is too short or has anything other than X/O/-/. in it.
+template<int N>
+bool parseBoardString(const std::string& squares, BasicBoard<N>& board) {
+    using G = BoardGeometry<N>;
+    if (squares.size() < static_cast<size_t>(G::SQUARES)) return false;
+    typename G::Bits black = 0, white = 0;
+    for (int sq = 0; sq < G::SQUARES; ++sq) {
+        char c = static_cast<char>(std::toupper(static_cast<unsigned char>(squares[sq])));
+        if (c == 'X' || c == '*') black |= G::bit(sq);
+        else if (c == 'O') white |= G::bit(sq);
+        else if (c != '-' && c != '.') return false;
+    }
+    board.setDiscs(black, white);
+    return true;
+}
+
+// A benchmark position: the board, the side to move and, when the position file has them, the
+// best moves and their score.
+struct BenchmarkPosition {
+    std::string name;
+    Board board;
+    PlayerColor sideToMove = PlayerColor::BLACK;
+    std::vector<int> expectedMoves;
+    bool hasExpectedScore = false;
+    int expectedScore = 0;
+};
+
+// Reads an FFO-style .obf line: 64 board characters (X black, O white, - or . empty, A1 to H8 row
+// by row), the side to move, then optional "move:score" pairs separated by ';'. Returns false for
+// comments (lines starting with '#' or '%') and anything else that is not a position.
+bool parseObfLine(const std::string& line, BenchmarkPosition& position) {
+    size_t start = line.find_first_not_of(" \t");
+    if (start == std::string::npos || line[start] == '#' || line[start] == '%') return false;
+    if (!parseBoardString(line.substr(start, BOARD_SIZE * BOARD_SIZE), position.board)) return false;
+
+    std::istringstream rest(line.substr(start + BOARD_SIZE * BOARD_SIZE));
+    std::string side;
+    rest >> side; // "X;" or "X" followed by " ;"
+    if (!side.empty() && side.back() == ';') side.pop_back();
+    position.sideToMove = (!side.empty() && std::toupper(static_cast<unsigned char>(side[0])) == 'O') ? PlayerColor::WHITE : PlayerColor::BLACK;
+
+    // Fields without a colon, such as the blank one in "X ;", are skipped below
+    std::string field;
+    while (std::getline(rest, field, ';')) {
+        size_t colon = field.find(':');
+        size_t moveStart = field.find_first_not_of(" \t");
+        if (colon == std::string::npos || moveStart == std::string::npos || colon < moveStart + 2) continue;
+        int col = std::toupper(static_cast<unsigned char>(field[moveStart])) - 'A';
+        int row = field[moveStart + 1] - '1';
+        if (col < 0 || col >= BOARD_SIZE || row < 0 || row >= BOARD_SIZE) continue;
+        int score = std::atoi(field.c_str() + colon + 1);
+        if (!position.hasExpectedScore || score > position.expectedScore) {
+            position.expectedMoves.clear();
+            position.expectedScore = score;
+            position.hasExpectedScore = true;
+        }
+        if (score == position.expectedScore) position.expectedMoves.push_back(row * BOARD_SIZE + col);
+    }
+    return true;
+}
+
+std::vector<BenchmarkPosition> loadObfPositions(const std::string& path) {
+    std::vector<BenchmarkPosition> positions;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        BenchmarkPosition position;
+        if (!parseObfLine(line, position)) continue;
+        position.name = "obf" + std::to_string(positions.size() + 1);
+        positions.push_back(position);
+    }
+    return positions;
+}
+
+// Built-in positions when no file is given: problems from the FFO endgame test suite (#40 on, 20
+// to 24 empties), with the best moves and exact scores published for them. The rest of the #40 to
+// #59 set runs from its .obf file.
+std::vector<BenchmarkPosition> builtinBenchmarkPositions() {
+    static const struct {
+        const char* name;
+        const char* obf;
+    } FFO_POSITIONS[] = {
+        { "ffo40", "O--OOOOX-OOOOOOXOOXXOOOXOOXOOOXXOOOOOOXX---OOOOX----O--X-------- X; A2:+38;" },
+        { "ffo41", "-OOOOO----OOOOX--OOOOOO-XXXXXOO--XXOOX--OOXOXX----OXXO---OOO--O- X; H4:+0;" },
+        { "ffo42", "--OOO-------XX-OOOOOOXOO-OOOOXOOX-OOOXXO---OOXOO---OOOXO--OOOO-- X; G2:+6;" },
+        { "ffo44", "--O-X-O---O-XO-O-OOXXXOOOOOOXXXOOOOOXX--XXOOXO----XXXX-----XXX-- O; D2:-14; B8:-14;" },
+        { "ffo45", "---XXXX-X-XXXO--XXOXOO--XXXOXO--XXOXXO---OXXXOO-O-OOOO------OO-- X; B2:+6;" },
+        { "ffo46", "---XXX----OOOX----OOOXX--OOOOXXX--OOOOXX--OXOXXX--XXOO---XXXX-O- X; B3:-8;" },
+    };
+    std::vector<BenchmarkPosition> positions;
+    for (const auto& entry : FFO_POSITIONS) {
+        BenchmarkPosition position;
+        parseObfLine(entry.obf, position);
+        position.name = entry.name;
+        positions.push_back(position);
+    }
+    return positions;
+}
+
+// With --bench random: games played at random from a fixed seed, stopped at 10 to 19 empty
+// squares, for timing only since nothing is known about them. mt19937 is fully specified, so
+// every build and platform gets the same boards.
+std::vector<BenchmarkPosition> randomBenchmarkPositions() {
+    std::vector<BenchmarkPosition> positions;
+    std::mt19937 rng(20240601);
+    while (positions.size() < 20) {
+        int targetEmpties = 10 + static_cast<int>(positions.size()) / 2;
+        Board board;
+        PlayerColor side = PlayerColor::BLACK;
+        while (Bitboard::popCount(board.emptySquares()) > targetEmpties && !board.isGameOver()) {
+            std::vector<Move> moves = board.getValidMoves(side);
+            if (!moves.empty()) {
+                Move move = moves[rng() % moves.size()];
+                board.makeMove(move.row * BOARD_SIZE + move.col, side);
+            }
+            side = getOpponent(side);
+        }
+        if (board.getValidMoveMask(side) == 0) continue;
+        BenchmarkPosition position;
+        position.name = "random" + std::to_string(positions.size() + 1);
+        position.board = board;
+        position.sideToMove = side;
+        positions.push_back(position);
+    }
+    return positions;
+}
+
+// Runs a fixed-depth search and an exact solve on every position and reports nodes, time, NPS and,
+// for positions with known results, whether the best move and score are right, as JSON, or as CSV
+// when 'outPath' ends in ".csv". 'obfPath' is a position file, "random" or empty for the built-in set.
+bool runBenchmark(const std::string& obfPath, int depth, int threads, double probCutConfidence, const std::string& outPath) {
+    std::vector<BenchmarkPosition> positions = obfPath.empty() ? builtinBenchmarkPositions()
+        : (obfPath == "random") ? randomBenchmarkPositions() : loadObfPositions(obfPath);
+    if (positions.empty()) {
+        fprintf(stderr, "No positions in %s\n", obfPath.c_str());
+        return false;
+    }
+
+    struct Result {
+        std::string name, mode;
+        int empties, move, score;
+        bool checked, correct;
+        uint64_t nodes;
+        double ms;
+    };
+    std::vector<Result> results;
+    Patterns::weights(); // Built lazily; keep that out of the first position's time.
+    auto squareName = [](int sq) {
+        return (sq < 0) ? std::string("--") : std::string(1, static_cast<char>('A' + sq % BOARD_SIZE)) + std::to_string(sq / BOARD_SIZE + 1);
+    };
+
+    for (const BenchmarkPosition& position : positions) {
+        int empties = Bitboard::popCount(position.board.emptySquares());
+        uint64_t player = position.board.discsOf(position.sideToMove);
+        uint64_t opponent = position.board.discsOf(getOpponent(position.sideToMove));
+
+        AIPlayer ai(depth, std::numeric_limits<int>::max(), threads);
+        ai.exactSolveEmpties = ai.wldSolveEmpties = -1;
+        ai.probCutConfidence = probCutConfidence;
+        auto start = std::chrono::high_resolution_clock::now();
+        Move move = ai.findBestMoveIterativeDeepening(position.board, position.sideToMove);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        int square = move.isValid() ? move.row * BOARD_SIZE + move.col : -1;
+        bool checked = !position.expectedMoves.empty();
+        bool correct = checked && std::find(position.expectedMoves.begin(), position.expectedMoves.end(), square) != position.expectedMoves.end();
+        results.push_back({ position.name, "depth" + std::to_string(depth), empties, square, ai.lastScore, checked, correct, ai.nodesSearched, ms });
+
+        EndgameSolver solver;
+        int bestSquare = -1;
+        start = std::chrono::high_resolution_clock::now();
+        int score = solver.solve(player, opponent, -SCORE_INFINITY, SCORE_INFINITY, bestSquare);
+        ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        checked = position.hasExpectedScore;
+        correct = checked && score == position.expectedScore &&
+            std::find(position.expectedMoves.begin(), position.expectedMoves.end(), bestSquare) != position.expectedMoves.end();
+        results.push_back({ position.name, "exact", empties, bestSquare, score, checked, correct, solver.countNodes(), ms });
+        fprintf(stderr, "%s: %d empties, depth %d %s, exact %s %+d (%.0f ms)\n", position.name.c_str(), empties, depth,
+            squareName(results[results.size() - 2].move).c_str(), squareName(bestSquare).c_str(), score, ms);
+    }
+
+    FILE* out = outPath.empty() ? stdout : fopen(outPath.c_str(), "w");
+    if (!out) {
+        fprintf(stderr, "Cannot write %s\n", outPath.c_str());
+        return false;
+    }
+    bool csv = outPath.size() >= 4 && outPath.compare(outPath.size() - 4, 4, ".csv") == 0;
+#if defined(__AVX2__)
+    const char* moveGenerator = "avx2";
+#else
+    const char* moveGenerator = "scalar";
+#endif
+    if (csv) {
+        fprintf(out, "position,mode,empties,move,score,checked,correct,nodes,time_ms,nps\n");
+        for (const Result& r : results) {
+            fprintf(out, "%s,%s,%d,%s,%d,%d,%d,%llu,%.3f,%.0f\n", r.name.c_str(), r.mode.c_str(), r.empties, squareName(r.move).c_str(),
+                r.score, r.checked, r.correct, static_cast<unsigned long long>(r.nodes), r.ms, r.nodes / std::max(r.ms / 1000.0, 1e-9));
+        }
+    }
+    else {
+        fprintf(out, "{\n  \"move_generator\": \"%s\",\n  \"threads\": %d,\n  \"depth\": %d,\n  \"probcut_confidence\": %.2f,\n  \"results\": [\n",
+            moveGenerator, threads, depth, probCutConfidence);
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            fprintf(out, "    {\"position\": \"%s\", \"mode\": \"%s\", \"empties\": %d, \"move\": \"%s\", \"score\": %d, "
+                "\"checked\": %s, \"correct\": %s, \"nodes\": %llu, \"time_ms\": %.3f, \"nps\": %.0f}%s\n",
+                r.name.c_str(), r.mode.c_str(), r.empties, squareName(r.move).c_str(), r.score, r.checked ? "true" : "false",
+                r.correct ? "true" : "false", static_cast<unsigned long long>(r.nodes), r.ms, r.nodes / std::max(r.ms / 1000.0, 1e-9),
+                (i + 1 < results.size()) ? "," : "");
+        }
+        fprintf(out, "  ],\n  \"summary\": {");
+        for (int exact = 0; exact < 2; ++exact) {
+            uint64_t nodes = 0;
+            double ms = 0.0;
+            int checked = 0, correct = 0;
+            for (const Result& r : results) {
+                if ((r.mode == "exact") != (exact == 1)) continue;
+                nodes += r.nodes;
+                ms += r.ms;
+                checked += r.checked;
+                correct += r.correct;
+            }
+            fprintf(out, "%s\n    \"%s\": {\"nodes\": %llu, \"time_ms\": %.3f, \"nps\": %.0f, \"checked\": %d, \"correct\": %d}",
+                exact ? "," : "", exact ? "exact" : "depth", static_cast<unsigned long long>(nodes), ms,
+                nodes / std::max(ms / 1000.0, 1e-9), checked, correct);
+        }
+        fprintf(out, "\n  }\n}\n");
+    }
+    if (out != stdout) fclose(out);
+    return true;
+}
+
+// Headless engine on stdin/stdout, one command per line, for scripted matches and regression
+// runs. Every command gets one reply line: "= <result>" on success or "? <error>".
+//   newgame                      start position, Black to move
+//   setboard <N*N squares> X|O   .obf-style board and side to move
+//   play <move>|pass             make a move for the side to move
+//   genmove [ms]                 search, play and print the move (or "pass")
+//   depth <n>                    maximum search depth for genmove
+//   showboard                    the position as "<N*N squares> X|O"
+//   quit
+template<int N>
+void runEngineProtocol(int threads, const std::string& bookPath, int timeLimitMs, double probCutConfidence) {
+    using G = BoardGeometry<N>;
+    using BoardType = BasicBoard<N>;
+    using AI = BasicAIPlayer<N>;
+    std::unique_ptr<AI> ai(new AI(60, timeLimitMs, threads));
+    ai->probCutConfidence = probCutConfidence;
+    // The book holds 8x8 positions only.
+    OpeningBook book;
+    if constexpr (N == BOARD_SIZE) book.open(bookPath);
+    BoardType board;
+    PlayerColor side = PlayerColor::BLACK;
+
+    auto squareName = [](const Move& move) {
+        return std::string(1, static_cast<char>('A' + move.col)) + std::to_string(move.row + 1);
+    };
+    auto reply = [](const std::string& text) {
+        fputs(text.c_str(), stdout);
+        fputc('\n', stdout);
+        fflush(stdout);
+    };
+
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        std::istringstream in(line);
+        std::string command;
+        if (!(in >> command) || command[0] == '#') continue;
+        std::transform(command.begin(), command.end(), command.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+        if (command == "quit") {
+            reply("=");
+            break;
+        }
+        else if (command == "newgame") {
+            board = BoardType();
+            side = PlayerColor::BLACK;
+            reply("=");
+        }
+        else if (command == "setboard") {
+            std::string squares, sideName;
+            in >> squares >> sideName;
+            BoardType parsed;
+            if (squares.size() != static_cast<size_t>(G::SQUARES) || !parseBoardString<N>(squares, parsed) || sideName.empty() ||
+                (std::toupper(static_cast<unsigned char>(sideName[0])) != 'X' && std::toupper(static_cast<unsigned char>(sideName[0])) != 'O')) {
+                reply("? expected " + std::to_string(G::SQUARES) + " squares of X, O or - and a side X or O");
+                continue;
+            }
+            board = parsed;
+            side = (std::toupper(static_cast<unsigned char>(sideName[0])) == 'O') ? PlayerColor::WHITE : PlayerColor::BLACK;
+            reply("=");
+        }
+        else if (command == "play") {
+            std::string text;
+            in >> text;
+            auto moveMask = board.getValidMoveMask(side);
+            if (text == "pass" || text == "PASS") {
+                if (moveMask) {
+                    reply("? cannot pass with legal moves");
+                    continue;
+                }
+                side = getOpponent(side);
+                reply("=");
+                continue;
+            }
+            int col = text.empty() ? -1 : std::toupper(static_cast<unsigned char>(text[0])) - 'A';
+            int row = (text.size() >= 2 && std::isdigit(static_cast<unsigned char>(text[1]))) ? std::atoi(text.c_str() + 1) - 1 : -1;
+            if (col < 0 || col >= N || row < 0 || row >= N || !G::test(moveMask, row * N + col)) {
+                reply("? illegal move " + text);
+                continue;
+            }
+            board.makeMove(row * N + col, side);
+            side = getOpponent(side);
+            reply("=");
+        }
+        else if (command == "genmove") {
+            int ms = timeLimitMs;
+            in >> ms;
+            if (board.isGameOver()) {
+                reply("? game over");
+                continue;
+            }
+            if (!board.getValidMoveMask(side)) {
+                side = getOpponent(side);
+                reply("= pass");
+                continue;
+            }
+            Move move;
+            bool bookMove = false;
+            if constexpr (N == BOARD_SIZE) bookMove = book.probe(board, side, move);
+            if (!bookMove) {
+                ai->timeLimitPerMove = std::chrono::milliseconds(std::max(1, ms));
+                move = ai->findBestMoveIterativeDeepening(board, side);
+            }
+            board.makeMove(move.row * N + move.col, side);
+            side = getOpponent(side);
+            reply("= " + squareName(move));
+        }
+        else if (command == "depth") {
+            int depth = 0;
+            if (!(in >> depth) || depth < 1) {
+                reply("? expected a depth of at least 1");
+                continue;
+            }
+            ai->maxDepth = depth;
+            reply("=");
+        }
+        else if (command == "showboard") {
+            std::string squares;
+            for (int sq = 0; sq < G::SQUARES; ++sq) {
+                squares += G::test(board.blackDiscs, sq) ? 'X' : G::test(board.whiteDiscs, sq) ? 'O' : '-';
+            }
+            reply("= " + squares + (side == PlayerColor::BLACK ? " X" : " O"));
+        }
+        else {
+            reply("? unknown command " + command);
+        }
+    }
+}
+
+// Prints perft totals for depths 1..maxDepth on the NxN board, with the rate.
+template<int N>
+void runPerft(int maxDepth) {
+    printf("Perft %dx%d\n%6s %14s %10s %14s\n", N, N, "depth", "leaves", "time ms", "leaves/s");
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        BasicBoard<N> board;
+        auto start = std::chrono::high_resolution_clock::now();
+        uint64_t leaves = perft<N>(board.blackDiscs, board.whiteDiscs, depth);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        printf("%6d %14llu %10.1f %14.0f\n", depth, static_cast<unsigned long long>(leaves), ms, leaves / std::max(ms / 1000.0, 1e-9));
+    }
+}
+
+// Solves the NxN game from the start position, resuming from 'tablePath' if an earlier run left
+// one. The table is checkpointed to disk after every null-window test and every CHECKPOINT_SECONDS.
+template<int N>
+bool runWeakSolve(const std::string& tablePath, size_t hashMb, int threads) {
+    const double CHECKPOINT_SECONDS = 60.0;
+    Variant::WeakSolver<N> solver(threads);
+    bool resumed = false;
+    if (!solver.open(tablePath, hashMb, resumed)) {
+        printf("Cannot map %s\n", tablePath.c_str());
+        return false;
+    }
+    const auto& progress = solver.progress();
+    printf("Solving %dx%d with %d threads, %zu MB table in %s\n", N, N, threads, solver.tableBytes() >> 20, tablePath.c_str());
+    if (resumed) {
+        printf("Resuming: score in [%d, %d] after %llu nodes, %.0f s\n", progress.lower, progress.upper,
+            static_cast<unsigned long long>(progress.nodes), progress.seconds);
+    }
+    fflush(stdout);
+
+    std::atomic<bool> testing{ true };
+    std::thread checkpointer;
+    // MTD(f): each test is centred on the last result; scores are always even on an even board.
+    int guess = (progress.lower > -N * N) ? progress.lower : (progress.upper < N * N) ? progress.upper : 0;
+    while (progress.lower < progress.upper) {
+        int value = (guess == progress.lower) ? guess + 2 : guess;
+        testing = true;
+        auto start = std::chrono::high_resolution_clock::now();
+        checkpointer = std::thread([&] {
+            auto last = std::chrono::high_resolution_clock::now();
+            while (testing) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                auto now = std::chrono::high_resolution_clock::now();
+                if (now - last > std::chrono::duration<double>(CHECKPOINT_SECONDS)) {
+                    solver.checkpoint();
+                    last = now;
+                    double seconds = std::chrono::duration<double>(now - start).count();
+                    printf("  checkpoint: %llu nodes, %.0f s\n", static_cast<unsigned long long>(solver.countNodes()), seconds);
+                    fflush(stdout);
+                }
+            }
+        });
+        guess = solver.test(value);
+        double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        testing = false;
+        checkpointer.join();
+        uint64_t nodes = solver.countNodes();
+        printf("score >= %+d? %s (%+d), %llu nodes, %.1f s, %.0f nodes/s\n", value, guess >= value ? "yes" : "no", guess,
+            static_cast<unsigned long long>(nodes), seconds, nodes / std::max(seconds, 1e-9));
+        fflush(stdout);
+    }
+
+    int score = progress.lower;
+    printf("%dx%d Othello is %s", N, N, score > 0 ? "a win for Black" : score < 0 ? "a win for White" : "a draw");
+    std::vector<int> line = solver.principalLine();
+    solver.checkpoint();
+    BasicBoard<N> board;
+    PlayerColor side = PlayerColor::BLACK;
+    std::string moves;
+    for (int sq : line) {
+        if (sq >= 0) {
+            board.makeMove(sq, side);
+            moves += std::string(moves.empty() ? "" : " ") + static_cast<char>('A' + sq % N) + std::to_string(sq / N + 1);
+        }
+        else {
+            moves += moves.empty() ? "pass" : " pass";
+        }
+        side = getOpponent(side);
+    }
+    printf(" with perfect play: %d-%d (score %+d for Black)\n", Bitboard::popCount(board.blackDiscs), Bitboard::popCount(board.whiteDiscs), score);
+    printf("Principal line: %s\n", moves.c_str());
+    printf("Total %llu nodes, %.0f s\n", static_cast<unsigned long long>(progress.nodes), progress.seconds);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
     std::ios_base::sync_with_stdio(false);
     std::cin.tie(NULL);
 
+    int aiThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    std::string weightsPath = "othello_weights.bin";
+    std::string bookPath = "othello_book.bin";
+    std::string benchmarkOutput;
+    std::string probCutPath = "othello_probcut.bin";
+    double probCutConfidence = ProbCut::DEFAULT_CONFIDENCE;
+    bool ponder = true;
+    int variantSize = BOARD_SIZE;
+    std::string mode;
+    std::vector<std::string> modeArgs;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            aiThreads = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--weights" && i + 1 < argc) {
+            weightsPath = argv[++i];
+        }
+        else if (arg == "--book" && i + 1 < argc) {
+            bookPath = argv[++i];
+        }
+        else if (arg == "--probcut-params" && i + 1 < argc) {
+            probCutPath = argv[++i];
+        }
+        else if (arg == "--probcut" && i + 1 < argc) {
+            probCutConfidence = std::max(0.0, std::atof(argv[++i]));
+        }
+        else if (arg == "--size" && i + 1 < argc) {
+            variantSize = std::atoi(argv[++i]);
+        }
+        else if (arg == "--no-ponder") {
+            ponder = false;
+        }
+        else if (arg == "--bench-out" && i + 1 < argc) {
+            benchmarkOutput = argv[++i];
+        }
+        else if (arg == "--thread-scaling" || arg == "--selfplay" || arg == "--train" || arg == "--build-book" || arg == "--bench" ||
+            arg == "--engine" || arg == "--fit-probcut" || arg == "--perft" || arg == "--weak-solve") {
+            mode = arg;
+            while (i + 1 < argc && argv[i + 1][0] != '-') modeArgs.push_back(argv[++i]);
+        }
+    }
+    auto modeArg = [&](size_t index, int fallback) {
+        return (index < modeArgs.size()) ? std::max(1, std::atoi(modeArgs[index].c_str())) : fallback;
+    };
+
+    // Trained evaluation weights, if there are any; otherwise the built-in defaults are used.
+    Patterns::loadWeights(weightsPath);
+    ProbCut::loadParams(probCutPath);
+
+    if (mode == "--thread-scaling") {
+        runThreadScaling(modeArg(0, aiThreads), modeArg(1, 9));
+        return 0;
+    }
+    if (mode == "--selfplay") {
+        std::string dataPath = (modeArgs.size() > 1) ? modeArgs[1] : "othello_selfplay.bin";
+        return runSelfPlay(modeArg(0, 1000), dataPath, aiThreads, modeArg(2, 6)) ? 0 : 1;
+    }
+    if (mode == "--train") {
+        std::string dataPath = modeArgs.empty() ? "othello_selfplay.bin" : modeArgs[0];
+        return runTraining(dataPath, weightsPath, aiThreads, modeArg(1, 100)) ? 0 : 1;
+    }
+    if (mode == "--fit-probcut") {
+        std::string dataPath = modeArgs.empty() ? "othello_selfplay.bin" : modeArgs[0];
+        return runProbCutFit(dataPath, probCutPath, aiThreads, modeArg(1, 100)) ? 0 : 1;
+    }
+    if (mode == "--engine" || mode == "--perft") {
+        bool engine = (mode == "--engine");
+        switch (variantSize) {
+        case 6:
+            if (engine) runEngineProtocol<6>(aiThreads, bookPath, modeArg(0, 1000), probCutConfidence);
+            else runPerft<6>(modeArg(0, 10));
+            return 0;
+        case BOARD_SIZE:
+            if (engine) runEngineProtocol<BOARD_SIZE>(aiThreads, bookPath, modeArg(0, 1000), probCutConfidence);
+            else runPerft<BOARD_SIZE>(modeArg(0, 9));
+            return 0;
+        case 10:
+            if (engine) runEngineProtocol<10>(aiThreads, bookPath, modeArg(0, 1000), probCutConfidence);
+            else runPerft<10>(modeArg(0, 8));
+            return 0;
+        default:
+            printf("Board size must be 6, 8 or 10\n");
+            return 1;
+        }
+    }
+    if (mode == "--weak-solve") {
+        // 8x8 is far out of reach, so here the board defaults to 6x6.
+        int size = (variantSize == BOARD_SIZE) ? 6 : variantSize;
+        size_t hashMb = static_cast<size_t>(modeArg(0, 1024));
+        std::string tablePath = (modeArgs.size() > 1) ? modeArgs[1] : "othello_solve" + std::to_string(size) + ".bin";
+        switch (size) {
+        case 4: return runWeakSolve<4>(tablePath, hashMb, aiThreads) ? 0 : 1;
+        case 6: return runWeakSolve<6>(tablePath, hashMb, aiThreads) ? 0 : 1;
+        default:
+            printf("Weak solving needs --size 4 or 6\n");
+            return 1;
+        }
+    }
+    if (mode == "--bench") {
+        // The position file (or "random") is optional, so a lone number is the depth.
+        bool hasFile = !modeArgs.empty() && !std::isdigit(static_cast<unsigned char>(modeArgs[0][0]));
+        std::string obfPath = hasFile ? modeArgs[0] : "";
+        return runBenchmark(obfPath, modeArg(hasFile ? 1 : 0, 10), aiThreads, probCutConfidence, benchmarkOutput) ? 0 : 1;
+    }
+    if (mode == "--build-book") {
+        return runBookBuilder(bookPath, modeArg(0, 7), modeArg(1, 8), aiThreads) ? 0 : 1;
+    }
+
 #ifdef _WIN32
     SetConsoleOutputCP(CP_UTF8);
     HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
@@ -766,7 +3970,8 @@ int main() {
         }
     }
     Console::clearScreen();
-    GameManager game(humanColor, aiSearchDepth, aiTimeLimitMs);
+    GameManager game(humanColor, aiSearchDepth, aiTimeLimitMs, aiThreads, bookPath, ponder);
+    game.ai.probCutConfidence = probCutConfidence;
     game.startGame();
 
     Console::showCursor();